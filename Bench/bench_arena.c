@@ -0,0 +1,88 @@
+/*
+ * Benchmark areny: cas game_step pri roznom pocte hracov na mape 30x60.
+ *
+ * Kazdy hrac ma autopilota; vyradeny hrac sa hned prida znova (game_join).
+ * Po kazdom ticku sa overi, ze occupied[] + volne policka sedia so sucasnymi
+ * hadmi (pocet obsadenych policok = sucet dlzok, ziadne policko dvakrat).
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "bench_util.h"
+
+#define TICKS 20000
+#define ROWS 30
+#define COLS 60
+
+static GameState g;
+static char seen[ROWS][COLS];
+
+/* 0 ak occupied[] presne zodpoveda telam hadov a free_count zvysku mapy */
+static int check(const GameState* a) {
+    memset(seen, 0, sizeof(seen));
+    int cells = 0;
+    for (int p = 0; p < a->max_players; p++) {
+        const Snake* s = &a->players[p].snake;
+        if (!a->players[p].active || !s->alive) continue;
+        for (int i = 0; i < s->len; i++) {
+            Pos c = snake_part(s, i);
+            if (seen[c.y][c.x] || !a->occupied[c.y][c.x]) return -1;
+            seen[c.y][c.x] = 1;
+            cells++;
+        }
+    }
+
+    int occupied = 0, open = 0;
+    for (int y = 1; y < a->rows - 1; y++) {
+        for (int x = 1; x < a->cols - 1; x++) {
+            occupied += a->occupied[y][x] != 0;
+            open += !a->obstacles[y][x];
+        }
+    }
+    return occupied == cells && a->free_count == open - cells ? 0 : -1;
+}
+
+static int run(int players) {
+    game_init_arena(&g, WORLD_WRAP, ROWS, COLS, OBSTACLE_PCT, players);
+    for (int p = 0; p < players; p++) game_join(&g);
+
+    long long step_sum = 0;
+    long deaths = 0, bad = 0, occupancy = 0;
+    for (int i = 0; i < TICKS; i++) {
+        for (int p = 0; p < players; p++) {
+            if (g.players[p].active) bench_autopilot(&g, p);
+        }
+
+        long long t0 = bench_now_ns();
+        game_step(&g);
+        step_sum += bench_now_ns() - t0;
+
+        for (int p = 0; p < players; p++) {
+            if (g.players[p].active && !g.players[p].snake.alive) {
+                game_leave(&g, p);
+                deaths++;
+            }
+        }
+        while (g.active_players < players && game_join(&g) >= 0) {}
+
+        if (check(&g) < 0) bad++;
+        occupancy += g.active_players;
+    }
+    game_destroy(&g);
+
+    printf("%7d %12.1f %14.1f %10ld %10.1f  %s\n",
+           players, (double)step_sum / TICKS, (double)step_sum / TICKS / players,
+           deaths, (double)occupancy / TICKS, bad ? "NESEDI!" : "ok");
+    return bad != 0;
+}
+
+int main(void) {
+    static const int counts[] = { 1, 8, 32, MAX_PLAYERS };
+
+    printf("bench_arena: 30x60 WRAP, %d tickov, autopilot pre kazdeho hraca\n", TICKS);
+    printf("%7s %12s %14s %10s %10s\n", "hraci", "step ns", "ns/hrac", "vyradeni", "priem.");
+
+    int err = 0;
+    for (int i = 0; i < 4; i++) err |= run(counts[i]);
+    return err;
+}
@@ -0,0 +1,116 @@
+/*
+ * Pomaly klient: session posiela ramce cez socketpair s malym bufferom,
+ * klient strieda useky, ked necita vobec, a useky, ked cita vsetko.
+ *
+ * Meria sa cas session_tick + session_flush (nesmie stat na plnom sockete)
+ * a kolko tickov sa zlucilo do neskorsieho ramca. Klient prijaty BINARY
+ * stream aplikuje na vlastnu mapu; po dobehnuti sa musi zhodovat so serverom.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include "../Common/protocol.h"
+#include "session.h"
+#include "bench_util.h"
+
+#define TICKS 20000
+#define STALL 60        // tickov bez citania
+#define READ 40         // potom tickov s citanim
+
+static GameState g;
+static Session s;
+static unsigned char in[65536];
+static int in_len;
+static char model[VIEW_ROWS][VIEW_COLS];
+static long frames_in;
+
+/* Precita co je v sockete a aplikuje cele binarne ramce na model. -1 pri chybe */
+static int client_read(int fd) {
+    ssize_t r;
+    while ((r = recv(fd, in + in_len, sizeof(in) - (size_t)in_len, MSG_DONTWAIT)) > 0) {
+        in_len += (int)r;
+
+        int pos = 0;
+        while (in_len - pos >= FRAME_HDR_SIZE) {
+            FrameHeader h;
+            frame_hdr_unpack(in + pos, &h);
+            if (h.magic != FRAME_MAGIC) return -1;
+            if ((uint32_t)(in_len - pos) < FRAME_HDR_SIZE + h.len) break;
+
+            const unsigned char* p = in + pos + FRAME_HDR_SIZE;
+            if (h.type == FRAME_KEY) {
+                for (int y = 0; y < h.rows; y++) memcpy(model[y], p + y * h.cols, h.cols);
+            }
+            else if (h.type == FRAME_DELTA) {
+                for (uint32_t i = 0; i < h.len; i += FRAME_CELL_SIZE) {
+                    model[get_u16(p + i + 2)][get_u16(p + i)] = (char)p[i + 4];
+                }
+            }
+            frames_in++;
+            pos += FRAME_HDR_SIZE + (int)h.len;
+        }
+        memmove(in, in + pos, (size_t)(in_len - pos));
+        in_len -= pos;
+    }
+    return 0;
+}
+
+int main(void) {
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0) { perror("socketpair"); return 1; }
+    int small = 4096;
+    setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &small, sizeof(small));
+    setsockopt(fds[1], SOL_SOCKET, SO_RCVBUF, &small, sizeof(small));
+
+    session_init(&s, fds[0], &g);
+    session_handle_command(&s, CMD_START " 30 60 WRAP NOOBS STANDARD " FRAMES_BINARY);
+
+    long long max_ns = 0, sum_ns = 0;
+    int ticks = 0, err = 0;
+    for (; ticks < TICKS && s.state != STATE_GAMEOVER; ticks++) {
+        bench_follow_cycle(&g);
+
+        long long t0 = bench_now_ns();
+        session_tick(&s);
+        if (session_flush(&s) < 0) { perror("send"); return 1; }
+        long long d = bench_now_ns() - t0;
+
+        sum_ns += d;
+        if (d > max_ns) max_ns = d;
+
+        if (ticks % (STALL + READ) >= STALL && client_read(fds[1]) < 0) err = 1;
+    }
+
+    /* klient dobehne: precita vsetko, posledny tick uz ide bez zlucenia */
+    while (session_pending(&s)) {
+        session_flush(&s);
+        if (client_read(fds[1]) < 0) err = 1;
+    }
+    if (s.state != STATE_GAMEOVER) {
+        session_tick(&s);
+        while (session_pending(&s)) {
+            session_flush(&s);
+            if (client_read(fds[1]) < 0) err = 1;
+        }
+    }
+
+    int differs = 0;
+    for (int y = 0; y < s.frames.view.rows; y++) {
+        if (memcmp(model[y], s.frames.cur[y], (size_t)s.frames.view.cols) != 0) differs = 1;
+    }
+
+    printf("bench_backpressure: 30x60 BINARY, %d tickov, klient %d tickov necita / %d cita\n",
+           ticks, STALL, READ);
+    printf("tick+flush avg %.1f us max %.1f us, ramce %ld (prijate %ld), zlucene ticky %ld, mapa %s\n",
+           sum_ns / 1e3 / ticks, max_ns / 1e3, s.out.frames, frames_in, s.out.coalesced,
+           err || differs ? "NESEDI!" : "ok");
+
+    close(fds[0]);
+    close(fds[1]);
+    game_destroy(&g);
+    return err || differs || s.out.coalesced == 0;
+}
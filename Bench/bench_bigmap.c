@@ -0,0 +1,124 @@
+/*
+ * Velke mapy: klient dostava len vyrez VIEW_ROWS x VIEW_COLS okolo hlavy,
+ * takze cena ramca za tick nezavisi od velkosti sveta.
+ *
+ * Pre kazdu velkost sa meria game_init, game_step a frame_build vo formatoch
+ * FULL, DELTA a BINARY (ns a bajty za tick). Pre porovnanie je tu aj cena
+ * celej mapy (game_compose_board + velkost textu MAP).
+ *
+ * Kazdy binarny ramec sa aplikuje na model klienta a porovna s vyrezom
+ * poskladanym odznova; hlava hraca ('@') musi byt vo vyreze vzdy.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../Common/protocol.h"
+#include "frame.h"
+#include "bench_util.h"
+
+#define TICKS 20000
+
+/* Aplikuje binarny ramec na model klienta */
+static void apply_binary(char model[VIEW_ROWS][VIEW_COLS], const char* frame) {
+    const unsigned char* p = (const unsigned char*)frame;
+    FrameHeader h;
+    frame_hdr_unpack(p, &h);
+    p += FRAME_HDR_SIZE;
+
+    if (h.type == FRAME_KEY) {
+        for (int y = 0; y < h.rows; y++) memcpy(model[y], p + y * h.cols, h.cols);
+    }
+    else if (h.type == FRAME_DELTA) {
+        for (uint32_t i = 0; i < h.len; i += FRAME_CELL_SIZE) {
+            model[get_u16(p + i + 2)][get_u16(p + i)] = (char)p[i + 4];
+        }
+    }
+}
+
+/* Model klienta = vyrez odznova a hlava je vo vyreze */
+static int view_bad(const GameState* g, const FrameState* fs, char model[VIEW_ROWS][VIEW_COLS]) {
+    static char ref[VIEW_ROWS][VIEW_COLS];
+    const MapView* v = &fs->view;
+    game_compose_view(g, 0, v, &ref[0][0], VIEW_COLS);
+
+    int bad = 0;
+    for (int y = 0; y < v->rows; y++) {
+        if (memcmp(model[y], ref[y], (size_t)v->cols) != 0) bad = 1;
+    }
+    Pos h = snake_head(&g->players[0].snake);
+    if (h.x < v->x || h.x >= v->x + v->cols || h.y < v->y || h.y >= v->y + v->rows ||
+        ref[h.y - v->y][h.x - v->x] != '@') bad = 1;
+    return bad;
+}
+
+static GameState g;
+
+static int run(int rows, int cols) {
+    static char out[8192];
+    static char model[VIEW_ROWS][VIEW_COLS];
+    static FrameState full, delta, bin;
+
+    long long t0 = bench_now_ns();
+    game_init(&g, WORLD_WRAP, MODE_STANDARD, 0, rows, cols, OBSTACLE_PCT);
+    double init_us = (double)(bench_now_ns() - t0) / 1e3;
+
+    /* cela mapa pre porovnanie: skladanie a velkost textu MAP */
+    t0 = bench_now_ns();
+    game_compose_board(&g, 0);
+    double board_us = (double)(bench_now_ns() - t0) / 1e3;
+    long map_bytes = (long)rows * (cols + 1) + 12;
+
+    frame_state_init(&full, FMT_FULL);
+    frame_state_init(&delta, FMT_DELTA);
+    frame_state_init(&bin, FMT_BINARY);
+
+    long long step_ns = 0, ns[FRAME_FORMATS] = { 0 }, bytes[FRAME_FORMATS] = { 0 };
+    int bad = 0, games = 1, max_len = 0;
+
+    for (int t = 0; t < TICKS; t++) {
+        bench_autopilot(&g, 0);
+        t0 = bench_now_ns();
+        game_step(&g);
+        step_ns += bench_now_ns() - t0;
+
+        if (!g.running) {
+            game_destroy(&g);
+            game_init(&g, WORLD_WRAP, MODE_STANDARD, 0, rows, cols, OBSTACLE_PCT);
+            games++;
+        }
+        if (g.players[0].snake.len > max_len) max_len = g.players[0].snake.len;
+
+        FrameState* fs[FRAME_FORMATS] = { &full, &delta, &bin };
+        for (int f = 0; f < FRAME_FORMATS; f++) {
+            t0 = bench_now_ns();
+            bytes[f] += frame_build(fs[f], &g, out, (int)sizeof(out));
+            ns[f] += bench_now_ns() - t0;
+        }
+        apply_binary(model, out);
+        bad += view_bad(&g, &bin, model);
+    }
+    game_destroy(&g);
+
+    printf("%4dx%-4d %9.1f %9.1f %8ld %7.1f", rows, cols, init_us, board_us, map_bytes,
+           (double)step_ns / TICKS);
+    for (int f = 0; f < FRAME_FORMATS; f++) {
+        printf(" %6.1f %6.1f", (double)ns[f] / TICKS, (double)bytes[f] / TICKS);
+    }
+    printf("  %5d %4d  %s\n", max_len, games, bad ? "NESEDI!" : "ok");
+    return bad;
+}
+
+int main(void) {
+    static const int sizes[][2] = { { 30, 60 }, { 200, 400 }, { 1000, 1000 }, { 2000, 2000 } };
+
+    srand(1);
+    printf("bench_bigmap: vyrez %dx%d, WRAP, prekazky %d%%, %d tickov (autopilot)\n",
+           VIEW_ROWS, VIEW_COLS, OBSTACLE_PCT, TICKS);
+    printf("%9s %9s %9s %8s %7s %13s %13s %13s  %5s %4s\n", "mapa", "init us", "mapa us",
+           "mapa B", "step ns", "FULL ns/B", "DELTA ns/B", "BINARY ns/B", "dlzka", "hry");
+
+    int bad = 0;
+    for (int i = 0; i < 4; i++) bad += run(sizes[i][0], sizes[i][1]);
+    return bad != 0;
+}
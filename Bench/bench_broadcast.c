@@ -0,0 +1,252 @@
+/*
+ * Benchmark vysielania divakom (WATCH): arena 30x60 s hracmi na autopilotovi,
+ * W divakov cez socketpair.
+ *
+ * 1) povodny sposob: kazdy divak ma vlastny FrameState, ramec sa sklada
+ *    a posiela pre kazdeho zvlast
+ * 2) broadcast: ramec sa zakoduje raz, divaci dostanu ten isty SharedFrame
+ *
+ * Meria sa cas ticku servera (bez citania na strane divakov). Overi sa, ze
+ * vsetci divaci dostali presne ten isty stream a ze jeden divak, ktory
+ * necita, ma zahodene ramce a ostatnych nespomali. Jeho resync (keyframe)
+ * ide zvlast: stream ostatnych sa musi zhodovat s ramcami FrameState,
+ * ktory o resyncu nevie.
+ *
+ * Na velkej mape (vyrez sa posuva) divak opakovane vypadne a cita dalej
+ * od resync keyframe; jeho model musi po kazdom ramci sediet s vyrezom.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include "../Common/protocol.h"
+#include "broadcast.h"
+#include "bench_util.h"
+
+#define TICKS 2000
+#define PLAYERS 16
+#define WATCHERS 200
+#define RESYNC_EVERY 7      // velka mapa: kazdy 7. tick divak vypadne
+
+static GameState g;
+static char out[8192];
+static char buf[65536];
+
+static int fds[WATCHERS + 1][2];    // [i][0] server, [i][1] divak; posledny necita
+static FrameState per[WATCHERS];
+static char ref_out[8192];
+static Watcher ws[WATCHERS + 1];
+static long long got[WATCHERS];
+static unsigned long sums[WATCHERS];
+
+static void arena_tick(GameState* a) {
+    static long long tick;
+
+    for (int p = 0; p < PLAYERS; p++) {
+        if (!a->players[p].snake.alive) {
+            game_leave(a, p);
+            game_join(a);
+        }
+        if (a->players[p].active) bench_autopilot(a, p);
+    }
+    game_step(a);
+
+    /*
+     * TIME = cislo ticku v sekundach, pol sekundy od hranice: vsetky ramce
+     * jedneho ticku (stream aj referencia) maju ten isty TIME
+     */
+    tick++;
+    a->start_ms = game_now_ms() - tick * 1000 - 500;
+}
+
+/* Divaci precitaju vsetko (okrem posledneho), kontrolny sucet streamu */
+static void drain(void) {
+    for (int i = 0; i < WATCHERS; i++) {
+        ssize_t r;
+        while ((r = recv(fds[i][1], buf, sizeof(buf), MSG_DONTWAIT)) > 0) {
+            got[i] += r;
+            for (ssize_t k = 0; k < r; k++) sums[i] = sums[i] * 31 + (unsigned char)buf[k];
+        }
+    }
+}
+
+static void reset_streams(void) {
+    drain();
+    memset(got, 0, sizeof(got));
+    memset(sums, 0, sizeof(sums));
+}
+
+static double run_per_client(FrameFormat f) {
+    for (int i = 0; i < WATCHERS; i++) {
+        frame_state_init(&per[i], f);
+        per[i].player = VIEWER_SPECTATOR;
+    }
+    reset_streams();
+
+    long long busy = 0;
+    for (int t = 0; t < TICKS; t++) {
+        arena_tick(&g);
+        long long t0 = bench_now_ns();
+        for (int i = 0; i < WATCHERS; i++) {
+            int n = frame_build(&per[i], &g, out, (int)sizeof(out));
+            send(fds[i][0], out, (size_t)n, MSG_DONTWAIT | MSG_NOSIGNAL);
+        }
+        busy += bench_now_ns() - t0;
+        drain();
+    }
+    return (double)busy / TICKS / 1e3;
+}
+
+static double run_broadcast(FrameFormat f, long* drops, long* resyncs, int* same) {
+    static Broadcast b;
+    static FrameState ref;
+    broadcast_init(&b, f);
+    frame_state_init(&ref, f);
+    ref.player = VIEWER_SPECTATOR;
+    int diverged = 0;
+    *resyncs = 0;
+    for (int i = 0; i <= WATCHERS; i++) {
+        watcher_release(&ws[i]);
+        memset(&ws[i], 0, sizeof(ws[i]));
+    }
+    reset_streams();
+
+    long long busy = 0;
+    for (int t = 0; t < TICKS; t++) {
+        arena_tick(&g);
+        long long t0 = bench_now_ns();
+        for (int i = 0; i <= WATCHERS; i++) b.resync |= !ws[i].synced;
+        SharedFrame* key;
+        SharedFrame* fr = broadcast_build(&b, &g, out, (int)sizeof(out), &key);
+        for (int i = 0; i <= WATCHERS; i++) {
+            watcher_offer(&ws[i], fds[i][0], !ws[i].synced && key ? key : fr);
+        }
+        busy += bench_now_ns() - t0;
+
+        /* stream nezavisi od resyncu */
+        int n = frame_build(&ref, &g, ref_out, (int)sizeof(ref_out));
+        if (!fr || fr->len != n || memcmp(fr->data, ref_out, (size_t)n) != 0) diverged++;
+        *resyncs += key != NULL;
+        shared_frame_unref(fr);
+        shared_frame_unref(key);
+        drain();
+    }
+
+    *drops = ws[WATCHERS].drops;
+    *same = diverged == 0;
+    for (int i = 1; i < WATCHERS; i++) {
+        if (got[i] != got[0] || sums[i] != sums[0] || ws[i].drops) *same = 0;
+    }
+    return (double)busy / TICKS / 1e3;
+}
+
+/* Binarny ramec na model divaka */
+static void apply_binary(char model[VIEW_ROWS][VIEW_COLS], const SharedFrame* f) {
+    const unsigned char* p = (const unsigned char*)f->data;
+    FrameHeader h;
+    frame_hdr_unpack(p, &h);
+    p += FRAME_HDR_SIZE;
+
+    if (h.type == FRAME_KEY) {
+        for (int y = 0; y < h.rows; y++) memcpy(model[y], p + y * h.cols, h.cols);
+    }
+    else if (h.type == FRAME_DELTA) {
+        for (uint32_t i = 0; i < h.len; i += FRAME_CELL_SIZE) {
+            model[get_u16(p + i + 2)][get_u16(p + i)] = (char)p[i + 4];
+        }
+    }
+}
+
+/*
+ * Arena 200x400: divak kazdych RESYNC_EVERY tickov vypadne (ako pri plnom
+ * sockete), dostane resync keyframe a potom delty streamu. Vrati pocet
+ * ramcov, po ktorych jeho model nesedel s vyrezom streamu.
+ */
+static int bigmap_resync(long* keys) {
+    static GameState big;
+    static Broadcast b;
+    static char model[VIEW_ROWS][VIEW_COLS], ref[VIEW_ROWS][VIEW_COLS];
+
+    *keys = 0;
+    if (game_init_arena(&big, WORLD_WRAP, 200, 400, OBSTACLE_PCT, PLAYERS) < 0) {
+        fprintf(stderr, "game_init_arena zlyhal\n");
+        return -1;
+    }
+    for (int p = 0; p < PLAYERS; p++) game_join(&big);
+    broadcast_init(&b, FMT_BINARY);
+
+    int synced = 0, bad = 0;
+    for (int t = 0; t < TICKS; t++) {
+        arena_tick(&big);
+        if (t % RESYNC_EVERY == 0) synced = 0;
+        b.resync = !synced;
+
+        SharedFrame* key;
+        SharedFrame* fr = broadcast_build(&b, &big, out, (int)sizeof(out), &key);
+        SharedFrame* use = !synced && key ? key : fr;
+
+        if (use && (synced || use->key)) {
+            apply_binary(model, use);
+            synced = 1;
+            *keys += use == key;
+
+            const MapView* v = &b.fs.view;
+            game_compose_view(&big, VIEWER_SPECTATOR, v, &ref[0][0], VIEW_COLS);
+            for (int y = 0; y < v->rows; y++) {
+                if (memcmp(model[y], ref[y], (size_t)v->cols) != 0) { bad++; break; }
+            }
+        }
+        shared_frame_unref(fr);
+        shared_frame_unref(key);
+    }
+    game_destroy(&big);
+    return bad;
+}
+
+int main(void) {
+    for (int i = 0; i <= WATCHERS; i++) {
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds[i]) < 0) { perror("socketpair"); return 1; }
+    }
+    /* posledny divak necita a ma maly buffer - musi zacat zahadzovat */
+    int small = 4096;
+    setsockopt(fds[WATCHERS][0], SOL_SOCKET, SO_SNDBUF, &small, sizeof(small));
+
+    game_init_arena(&g, WORLD_WRAP, 30, 60, OBSTACLE_PCT, PLAYERS);
+    for (int p = 0; p < PLAYERS; p++) game_join(&g);
+
+    static const char* names[] = { "FULL", "DELTA", "BINARY" };
+
+    printf("bench_broadcast: arena 30x60, %d hracov, %d divakov + 1 necitajuci, %d tickov\n",
+           PLAYERS, WATCHERS, TICKS);
+    printf("%-7s %16s %16s %8s %10s %8s %s\n",
+           "format", "kazdy zvlast us", "broadcast us", "zrychl.", "zahodene", "resync", "streamy");
+
+    int err = 0;
+    for (int f = 0; f < FRAME_FORMATS; f++) {
+        double a = run_per_client((FrameFormat)f);
+        long drops, resyncs;
+        int same;
+        double b = run_broadcast((FrameFormat)f, &drops, &resyncs, &same);
+
+        printf("%-7s %16.1f %16.1f %7.1fx %10ld %8ld %s\n", names[f], a, b, a / b, drops,
+               resyncs, same && drops > 0 ? "ok" : "CHYBA!");
+        if (!same || drops == 0) err = 1;
+    }
+
+    long keys;
+    int bad = bigmap_resync(&keys);
+    printf("arena 200x400 BINARY: divak vypadne kazdy %d. tick, %ld resync keyframe, "
+           "nesediace ramce %d  %s\n", RESYNC_EVERY, keys, bad, bad == 0 && keys > 0 ? "ok" : "CHYBA!");
+    if (bad != 0 || keys == 0) err = 1;
+
+    for (int i = 0; i <= WATCHERS; i++) {
+        watcher_release(&ws[i]);
+        close(fds[i][0]);
+        close(fds[i][1]);
+    }
+    game_destroy(&g);
+    return err;
+}
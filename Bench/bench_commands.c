@@ -0,0 +1,154 @@
+/*
+ * Stres test prikazoveho parsera (session_feed): tisice prikazov
+ * poslanych naraz cez socket, rozsekanych na nahodne kusy.
+ * Overuje, ze sa ziadny prikaz nestratil, a meria priepustnost.
+ *
+ * Cez socket prikazy preberaju dve vlakna ako v klasickom serveri:
+ * recv (session_feed -> InputQueue) a game loop (session_apply_input).
+ * Ked je fronta plna, recv thread caka na room_fd (necita socket), kym
+ * game loop frontu nevyberie - nic sa nezahodi.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/eventfd.h>
+
+#include "../Common/protocol.h"
+#include "session.h"
+#include "bench_util.h"
+
+#define COMMANDS 200000
+#define APPLY_US 50     // perioda "ticku", ktory vybera frontu
+
+static char stream[COMMANDS * 8];
+static int stream_len;
+
+/* Pisatel: posiela stream po nahodne velkych kusoch (1..300 B) */
+static void* writer(void* arg) {
+    int fd = *(int*)arg;
+    int pos = 0;
+    unsigned seed = 7;
+
+    while (pos < stream_len) {
+        seed = seed * 1103515245u + 12345u;
+        int chunk = 1 + (int)((seed >> 16) % 300);
+        if (chunk > stream_len - pos) chunk = stream_len - pos;
+        int w = (int)send(fd, stream + pos, (size_t)chunk, 0);
+        if (w <= 0) break;
+        pos += w;
+    }
+    shutdown(fd, SHUT_WR);
+    return NULL;
+}
+
+static atomic_int feeding;
+
+/* Game loop: vybera frontu, kym recv thread posiela */
+static void* consumer(void* arg) {
+    Session* s = (Session*)arg;
+    struct timespec ts = { 0, APPLY_US * 1000L };
+
+    while (1) {
+        int last = !atomic_load(&feeding);
+        pthread_mutex_lock(&s->g->mtx);
+        session_apply_input(s);
+        pthread_mutex_unlock(&s->g->mtx);
+        if (last) break;
+        nanosleep(&ts, NULL);
+    }
+    return NULL;
+}
+
+static void new_session(Session* s, GameState* g) {
+    memset(g, 0, sizeof(*g));
+    session_init(s, -1, g);
+    session_handle_command(s, CMD_START " 20 40 WRAP NOOBS STANDARD");
+    s->commands = 0;
+}
+
+int main(void) {
+    static const char* cmds[] = { CMD_MOVE " w\n", CMD_MOVE " a\n", CMD_MOVE " s\n",
+                                  CMD_MOVE " d\n", CMD_PAUSE "\n", CMD_RESUME "\n" };
+    srand(1);
+    for (int i = 0; i < COMMANDS; i++) {
+        const char* c = cmds[rand() % 6];
+        memcpy(stream + stream_len, c, strlen(c));
+        stream_len += (int)strlen(c);
+    }
+
+    GameState g;
+    Session s;
+    int failed = 0;
+
+    /* 1) v pamati: stream rozsekany na nahodne kusy */
+    new_session(&s, &g);
+    long long t0 = bench_now_ns();
+    for (int pos = 0; pos < stream_len; ) {
+        int chunk = 1 + rand() % 64;
+        if (chunk > stream_len - pos) chunk = stream_len - pos;
+        session_feed(&s, stream + pos, chunk);
+        session_apply_input(&s);
+        pos += chunk;
+    }
+    long long t1 = bench_now_ns();
+    printf("memory:  %d prikazov, spracovanych %lu, aplikovanych %lu, %.1f M prikazov/s\n",
+           COMMANDS, s.commands, s.applied, COMMANDS / ((t1 - t0) / 1e9) / 1e6);
+    if (s.commands != COMMANDS || s.applied != COMMANDS) failed = 1;
+    game_destroy(&g);
+
+    /* 2) cez socket: pipelined prikazy, TCP-like spajanie aj delenie */
+    int sv[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) < 0) { perror("socketpair"); return 1; }
+
+    new_session(&s, &g);
+    s.room_fd = eventfd(0, 0);
+    if (s.room_fd < 0) { perror("eventfd"); return 1; }
+    pthread_t th, game;
+    atomic_store(&feeding, 1);
+    t0 = bench_now_ns();
+    pthread_create(&th, NULL, writer, &sv[1]);
+    pthread_create(&game, NULL, consumer, &s);
+
+    char buf[FEED_MAX];
+    long reads = 0;
+    long waits = 0;
+    while (1) {
+        int r = (int)recv(sv[0], buf, 1 + rand() % sizeof(buf), 0);
+        if (r <= 0) break;
+        session_feed(&s, buf, r);
+        reads++;
+        /* ako recv_loop servera: plna fronta = necitame socket, kym tick neprevezme prikazy */
+        while (session_push_parked(&s) > 0) {
+            uint64_t n;
+            if (read(s.room_fd, &n, sizeof(n)) < 0) { perror("read"); return 1; }
+            waits++;
+        }
+    }
+    t1 = bench_now_ns();
+    atomic_store(&feeding, 0);
+    pthread_join(th, NULL);
+    pthread_join(game, NULL);
+    close(sv[0]);
+    close(sv[1]);
+    close(s.room_fd);
+
+    unsigned long full = atomic_load(&s.input.full);
+    printf("socket:  %d prikazov v %ld recv, spracovanych %lu, %.1f M prikazov/s\n",
+           COMMANDS, reads, s.commands, COMMANDS / ((t1 - t0) / 1e9) / 1e6);
+    printf("fronta:  aplikovanych %lu, plna %lu-krat (recv cakal %ld-krat), "
+           "cakanie avg %.1f us max %.1f us\n",
+           s.applied, full, waits, s.applied ? s.input_wait_sum_ns / 1e3 / s.applied : 0.0,
+           s.input_wait_max_ns / 1e3);
+    if (s.commands != COMMANDS || s.applied != COMMANDS) failed = 1;
+    game_destroy(&g);
+
+    printf("bench_commands: %s\n", failed ? "STRATENE PRIKAZY" : "ziadny prikaz sa nestratil");
+    return failed;
+}
@@ -0,0 +1,171 @@
+/*
+ * Headless simulacia hry bez siete a bez klienta.
+ *
+ * Pre kazdu kombinaciu velkosti mapy, typu sveta a hustoty prekazok
+ * bezi ticky ako server: autopilot zvoli smer, game_step, game_render_map.
+ * Po konci hry sa hned zacne nova (game_init sa meria zvlast).
+ *
+ * Vypis: ticky/s, ns/tick (p50/p90/p99/max), priemer game_step a renderu,
+ * bajty renderu na tick. S -o FILE zapise to iste ako CSV (jeden riadok
+ * na konfiguraciu) na porovnavanie medzi verziami.
+ *
+ * Pouzitie: bench_engine [-n TICKS] [-o FILE]
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "bench_util.h"
+
+#define DEFAULT_TICKS 100000
+#define OUT_CAP 8192
+
+typedef struct {
+    int rows, cols;
+    WorldType world;
+    int obstacle_pct;
+} Config;
+
+typedef struct {
+    long ticks;
+    long games;
+    double ticks_per_sec;
+    long long p50, p90, p99, max;
+    double step_avg, render_avg, init_avg_us;
+    double bytes_avg;
+} Result;
+
+static int cmp_ll(const void* a, const void* b) {
+    long long x = *(const long long*)a, y = *(const long long*)b;
+    return (x > y) - (x < y);
+}
+
+static GameState g;
+static char out[OUT_CAP];
+
+static void run(const Config* c, long ticks, long long* samples, Result* r) {
+    long long step_sum = 0, render_sum = 0, init_sum = 0, bytes = 0;
+    long games = 1;
+
+    long long t = bench_now_ns();
+    game_init(&g, c->world, MODE_STANDARD, 0, c->rows, c->cols, c->obstacle_pct);
+    init_sum += bench_now_ns() - t;
+    game_render_map(&g, 0, out, sizeof(out));
+
+    long long t_start = bench_now_ns();
+    for (long i = 0; i < ticks; i++) {
+        if (!g.running) {
+            game_destroy(&g);
+            t = bench_now_ns();
+            game_init(&g, c->world, MODE_STANDARD, 0, c->rows, c->cols, c->obstacle_pct);
+            init_sum += bench_now_ns() - t;
+            game_render_map(&g, 0, out, sizeof(out));
+            games++;
+        }
+
+        bench_autopilot(&g, 0);
+
+        long long t0 = bench_now_ns();
+        game_step(&g);
+        long long t1 = bench_now_ns();
+        int n = game_render_map(&g, 0, out, sizeof(out));
+        long long t2 = bench_now_ns();
+
+        step_sum += t1 - t0;
+        render_sum += t2 - t1;
+        samples[i] = t2 - t0;
+        bytes += n;
+    }
+    long long elapsed = bench_now_ns() - t_start;
+    game_destroy(&g);
+
+    qsort(samples, (size_t)ticks, sizeof(*samples), cmp_ll);
+
+    r->ticks = ticks;
+    r->games = games;
+    r->ticks_per_sec = ticks / (elapsed / 1e9);
+    r->p50 = samples[ticks * 50 / 100];
+    r->p90 = samples[ticks * 90 / 100];
+    r->p99 = samples[ticks * 99 / 100];
+    r->max = samples[ticks - 1];
+    r->step_avg = (double)step_sum / ticks;
+    r->render_avg = (double)render_sum / ticks;
+    r->init_avg_us = (double)init_sum / games / 1e3;
+    r->bytes_avg = (double)bytes / ticks;
+}
+
+int main(int argc, char** argv) {
+    long ticks = DEFAULT_TICKS;
+    const char* csv_path = NULL;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:o:h")) != -1) {
+        switch (opt) {
+        case 'n': ticks = atol(optarg); break;
+        case 'o': csv_path = optarg; break;
+        default:
+            fprintf(stderr, "Pouzitie: %s [-n TICKS] [-o FILE.csv]\n", argv[0]);
+            return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (ticks < 100) ticks = 100;
+
+    static const int sizes[][2] = { { 20, 40 }, { 30, 60 } };
+    static const WorldType worlds[] = { WORLD_WALLS, WORLD_WRAP };
+    static const int pcts[] = { 0, OBSTACLE_PCT, 20 };
+
+    long long* samples = malloc((size_t)ticks * sizeof(*samples));
+    if (!samples) { perror("malloc"); return 1; }
+
+    FILE* csv = NULL;
+    if (csv_path) {
+        csv = fopen(csv_path, "w");
+        if (!csv) { perror(csv_path); free(samples); return 1; }
+        fprintf(csv, "rows,cols,world,obstacle_pct,ticks,games,ticks_per_sec,"
+                     "p50_ns,p90_ns,p99_ns,max_ns,step_avg_ns,render_avg_ns,"
+                     "init_avg_us,bytes_per_tick\n");
+    }
+
+    printf("bench_engine: %ld tickov na konfiguraciu (autopilot, step + render)\n", ticks);
+    printf("%-7s %-5s %4s %10s %7s %7s %7s %8s %8s %8s %8s %7s\n",
+           "mapa", "svet", "obs", "ticky/s", "p50 ns", "p90 ns", "p99 ns", "max ns",
+           "step ns", "rend ns", "init us", "B/tick");
+
+    long total = 0;
+    for (int si = 0; si < 2; si++) {
+        for (int wi = 0; wi < 2; wi++) {
+            for (int pi = 0; pi < 3; pi++) {
+                Config c = { sizes[si][0], sizes[si][1], worlds[wi], pcts[pi] };
+                const char* wname = c.world == WORLD_WALLS ? "WALLS" : "WRAP";
+                Result r;
+                run(&c, ticks, samples, &r);
+                total += r.ticks;
+
+                char map[16];
+                snprintf(map, sizeof(map), "%dx%d", c.rows, c.cols);
+                printf("%-7s %-5s %3d%% %10.0f %7lld %7lld %7lld %8lld %8.1f %8.1f %8.1f %7.0f\n",
+                       map, wname, c.obstacle_pct, r.ticks_per_sec,
+                       r.p50, r.p90, r.p99, r.max,
+                       r.step_avg, r.render_avg, r.init_avg_us, r.bytes_avg);
+
+                if (csv) {
+                    fprintf(csv, "%d,%d,%s,%d,%ld,%ld,%.0f,%lld,%lld,%lld,%lld,%.1f,%.1f,%.1f,%.0f\n",
+                            c.rows, c.cols, wname, c.obstacle_pct, r.ticks, r.games,
+                            r.ticks_per_sec, r.p50, r.p90, r.p99, r.max,
+                            r.step_avg, r.render_avg, r.init_avg_us, r.bytes_avg);
+                }
+            }
+        }
+    }
+
+    printf("spolu %ld tickov\n", total);
+    if (csv) {
+        fclose(csv);
+        printf("CSV: %s\n", csv_path);
+    }
+    free(samples);
+    return 0;
+}
@@ -0,0 +1,121 @@
+/*
+ * Benchmark formatov ramcov: kolko bajtov za tick posiela server
+ * v rezime FULL (cela mapa), DELTA (keyframe + zmenene policka)
+ * a BINARY (binarna hlavicka + keyframe/delta).
+ *
+ * Kazdy DELTA a BINARY ramec sa zaroven aplikuje na model klienta a porovna
+ * s mapou na serveri, aby bolo vidno, ze sa nic nestratilo.
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "../Common/protocol.h"
+#include "frame.h"
+#include "bench_util.h"
+
+#define TICKS 20000
+
+/* Aplikuje ramec (plny alebo DELTA) na model klienta */
+static void apply_frame(char model[VIEW_ROWS][VIEW_COLS], const char* frame) {
+    const char* line = frame;
+    int in_map = 0, in_delta = 0, row = 0;
+
+    while (*line) {
+        const char* nl = strchr(line, '\n');
+        int len = (int)(nl - line);
+
+        if (in_map) {
+            if (strncmp(line, "ENDMAP", 6) == 0) in_map = 0;
+            else if (strncmp(line, "===", 3) != 0) memcpy(model[row++], line, (size_t)len);
+        }
+        else if (in_delta) {
+            int x, y;
+            if (strncmp(line, CMD_ENDDELTA, strlen(CMD_ENDDELTA)) == 0) in_delta = 0;
+            else if (sscanf(line + 1, "%d %d", &x, &y) == 2) model[y][x] = line[0];
+        }
+        else if (strncmp(line, CMD_MAP "\n", strlen(CMD_MAP) + 1) == 0) in_map = 1;
+        else if (strncmp(line, CMD_DELTA " ", strlen(CMD_DELTA) + 1) == 0) in_delta = 1;
+
+        line = nl + 1;
+    }
+}
+
+/* Aplikuje binarny ramec na model klienta */
+static void apply_binary(char model[VIEW_ROWS][VIEW_COLS], const char* frame) {
+    const unsigned char* p = (const unsigned char*)frame;
+    FrameHeader h;
+    frame_hdr_unpack(p, &h);
+    p += FRAME_HDR_SIZE;
+
+    if (h.type == FRAME_KEY) {
+        for (int y = 0; y < h.rows; y++) memcpy(model[y], p + y * h.cols, h.cols);
+    }
+    else if (h.type == FRAME_DELTA) {
+        for (uint32_t i = 0; i < h.len; i += FRAME_CELL_SIZE) {
+            model[get_u16(p + i + 2)][get_u16(p + i)] = (char)p[i + 4];
+        }
+    }
+}
+
+static int model_differs(char model[VIEW_ROWS][VIEW_COLS], const GameState* g) {
+    for (int y = 0; y < g->rows; y++) {
+        if (memcmp(model[y], g->board[y], (size_t)g->cols) != 0) return 1;
+    }
+    return 0;
+}
+
+static void run(int rows, int cols, int obstacles) {
+    static char out[8192];
+    static char model[VIEW_ROWS][VIEW_COLS];
+    static char bmodel[VIEW_ROWS][VIEW_COLS];
+    GameState g;
+    FrameState full, delta, bin;
+
+    game_init(&g, WORLD_WRAP, MODE_STANDARD, 0, rows, cols, obstacles ? OBSTACLE_PCT : 0);
+    frame_state_init(&full, FMT_FULL);
+    frame_state_init(&delta, FMT_DELTA);
+    frame_state_init(&bin, FMT_BINARY);
+
+    long long full_bytes = 0, delta_bytes = 0, bin_bytes = 0;
+    int mismatches = 0, games = 1;
+
+    for (int t = 0; t < TICKS; t++) {
+        full_bytes += frame_build(&full, &g, out, (int)sizeof(out));
+        bench_autopilot(&g, 0);
+
+        delta_bytes += frame_build(&delta, &g, out, (int)sizeof(out));
+        apply_frame(model, out);
+        game_compose_board(&g, 0);
+        mismatches += model_differs(model, &g);
+
+        bin_bytes += frame_build(&bin, &g, out, (int)sizeof(out));
+        apply_binary(bmodel, out);
+        mismatches += model_differs(bmodel, &g);
+
+        game_step(&g);
+        if (!g.running) {
+            game_destroy(&g);
+            game_init(&g, WORLD_WRAP, MODE_STANDARD, 0, rows, cols, obstacles ? OBSTACLE_PCT : 0);
+            games++;
+        }
+    }
+    game_destroy(&g);
+
+    double full_avg = (double)full_bytes / TICKS;
+    double delta_avg = (double)delta_bytes / TICKS;
+    double bin_avg = (double)bin_bytes / TICKS;
+    printf("%3dx%-3d %-5s  FULL %7.1f  DELTA %6.1f (%4.1fx)  BINARY %6.1f (%4.1fx) B/tick"
+           "  games %d  mismatches %d\n",
+           rows, cols, obstacles ? "OBS" : "NOOBS", full_avg,
+           delta_avg, full_avg / delta_avg, bin_avg, full_avg / bin_avg, games, mismatches);
+}
+
+int main(void) {
+    srand(1);
+    printf("bench_frames: %d tickov, keyframe kazdych %d tickov\n", TICKS, KEYFRAME_INTERVAL);
+    run(20, 40, 0);
+    run(20, 40, 1);
+    run(25, 50, 1);
+    run(30, 60, 1);
+    return 0;
+}
@@ -0,0 +1,125 @@
+/*
+ * Viac hier roznych velkosti naraz v roznych vlaknach (ako manager server).
+ * Kazda hra ma vlastny seed a vlastneho "hraca" (generator mimo hry), takze
+ * jej priebeh nezavisi od toho, v ktorom vlakne a s cim sucasne bezi.
+ *
+ * Hry sa najprv odohraju po jednej v hlavnom vlakne (referencia), potom
+ * pri 1..8 vlaknach naraz. Otlacok kazdej hry sa musi zhodovat s referenciou
+ * a po kazdej hre musi occupied[] presne zodpovedat telu hada.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "gamelog.h"
+#include "bench_util.h"
+
+#define GAMES 16
+#define TICKS 200000        // tickov na hru (skoncena hra zacne znova s dalsim seedom)
+#define MAX_THREADS 8
+
+static const int sizes[][2] = { { 20, 40 }, { 25, 50 }, { 30, 60 }, { 60, 120 }, { 200, 400 } };
+
+typedef struct {
+    int id;
+    int nthreads;
+    uint32_t hash[GAMES];
+    int bad;
+} Worker;
+
+/* occupied[] presne zodpoveda telu hada */
+static int corrupted(const GameState* g) {
+    const Snake* s = &g->players[0].snake;
+    int cells = 0;
+    for (int y = 0; y < g->rows; y++)
+        for (int x = 0; x < g->cols; x++) cells += g->occupied[y][x];
+    for (int i = 0; i < s->len; i++) {
+        Pos p = snake_part(s, i);
+        if (!g->occupied[p.y][p.x]) return 1;
+    }
+    return cells != s->len;
+}
+
+static void new_game(GameState* g, int i, unsigned round) {
+    if (game_init_seeded(g, i % 2 ? WORLD_WRAP : WORLD_WALLS, MODE_STANDARD, 0,
+                         sizes[i % 5][0], sizes[i % 5][1], i % 3 ? OBSTACLE_PCT : 0,
+                         (unsigned)i * 1000u + round + 1) < 0) {
+        fprintf(stderr, "hra %d (%dx%d) sa nevytvorila\n", i, sizes[i % 5][0], sizes[i % 5][1]);
+        exit(1);
+    }
+}
+
+/* Odohra hru i (TICKS tickov), vrati otlacok vsetkych jej kol */
+static uint32_t play(GameState* g, int i, int* bad) {
+    GameRng r;
+    rng_seed(&r, (uint64_t)i, 1);
+    unsigned round = 0;
+    uint32_t h = 0;
+
+    new_game(g, i, round);
+    for (int t = 0; t < TICKS; t++) {
+        /* hrac s vlastnym generatorom, rand() nie je pre vlakna */
+        int start = (int)rng_below(&r, 4);
+        int keep = rng_below(&r, 8) != 0;
+        bench_steer(g, 0, start, keep);
+        game_step(g);
+        if (!g->running) {
+            if (corrupted(g)) (*bad)++;
+            h = h * 31u + gamelog_hash(g);
+            game_destroy(g);
+            new_game(g, i, ++round);
+        }
+    }
+    if (corrupted(g)) (*bad)++;
+    h = h * 31u + gamelog_hash(g);
+    game_destroy(g);
+    return h;
+}
+
+static void* worker(void* arg) {
+    Worker* w = arg;
+    GameState* g = calloc(1, sizeof(*g));
+    if (!g) { perror("calloc"); exit(1); }
+
+    for (int i = w->id; i < GAMES; i += w->nthreads) w->hash[i] = play(g, i, &w->bad);
+    free(g);
+    return NULL;
+}
+
+int main(void) {
+    static const int threads[] = { 1, 2, 4, 8 };
+    static GameState g;
+    uint32_t ref[GAMES];
+    int bad = 0;
+
+    printf("bench_games: %d hier (20x40 .. 200x400, WALLS/WRAP, s/bez prekazok), %d tickov na hru\n",
+           GAMES, TICKS);
+
+    for (int i = 0; i < GAMES; i++) ref[i] = play(&g, i, &bad);
+
+    for (int k = 0; k < 4; k++) {
+        int n = threads[k];
+        pthread_t th[MAX_THREADS];
+        Worker w[MAX_THREADS];
+
+        long long t0 = bench_now_ns();
+        for (int i = 0; i < n; i++) {
+            w[i] = (Worker){ .id = i, .nthreads = n };
+            pthread_create(&th[i], NULL, worker, &w[i]);
+        }
+        int diff = 0, corrupt = 0;
+        for (int i = 0; i < n; i++) {
+            pthread_join(th[i], NULL);
+            corrupt += w[i].bad;
+            for (int j = i; j < GAMES; j += n) diff += w[i].hash[j] != ref[j];
+        }
+        double sec = (bench_now_ns() - t0) / 1e9;
+
+        printf("vlakna %d: %8.2f M tickov/s  rozdielne hry %d  poskodene %d  %s\n",
+               n, (double)GAMES * TICKS / sec / 1e6, diff, corrupt,
+               diff || corrupt ? "NESEDI!" : "ok");
+        bad += diff + corrupt;
+    }
+    return bad != 0;
+}
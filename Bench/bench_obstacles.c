@@ -0,0 +1,125 @@
+/*
+ * Benchmark generovania prekazok (cas game_init) pri roznych
+ * velkostiach mapy a hustotach prekazok.
+ *
+ * Kazda vygenerovana mapa sa overi jednym BFS: vsetky volne policka
+ * musia byt navzajom dosiahnutelne.
+ * Pre porovnanie je tu aj povodny sposob (BFS po kazdej prekazke), len pri
+ * malych mapach - pri vacsich by trval minuty.
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "bench_util.h"
+
+#define REPS 50
+#define LEGACY_MAX_CELLS 20000
+#define BFS_MAX_CELLS (2000 * 2000)     // najvacsia mapa v zozname nizsie
+
+static int qx[BFS_MAX_CELLS], qy[BFS_MAX_CELLS];
+static char visited[BFS_MAX_CELLS];     // [y * cols + x]
+
+/* Pocet volnych policok dosiahnutelnych z prveho volneho, -1 ak nie su vsetky */
+static int connected(const GameState* g) {
+    int free_count = 0, sx = -1, sy = -1;
+    for (int y = 1; y < g->rows - 1; y++) {
+        for (int x = 1; x < g->cols - 1; x++) {
+            if (g->obstacles[y][x]) continue;
+            if (sx < 0) { sx = x; sy = y; }
+            free_count++;
+        }
+    }
+    if (sx < 0) return 0;
+
+    static const int dx[] = { 0, 0, 1, -1 };
+    static const int dy[] = { 1, -1, 0, 0 };
+    memset(visited, 0, (size_t)g->rows * (size_t)g->cols);
+    int head = 0, tail = 0;
+    qx[tail] = sx; qy[tail] = sy; tail++;
+    visited[sy * g->cols + sx] = 1;
+
+    while (head < tail) {
+        int x = qx[head], y = qy[head];
+        head++;
+        for (int i = 0; i < 4; i++) {
+            int nx = x + dx[i], ny = y + dy[i];
+            if (nx > 0 && nx < g->cols - 1 && ny > 0 && ny < g->rows - 1 &&
+                !visited[ny * g->cols + nx] && !g->obstacles[ny][nx]) {
+                visited[ny * g->cols + nx] = 1;
+                qx[tail] = nx; qy[tail] = ny; tail++;
+            }
+        }
+    }
+    return tail == free_count ? tail : -1;
+}
+
+/* Povodne generovanie: po kazdej prekazke BFS cez celu mapu */
+static void legacy_obstacles(GameState* g, int pct) {
+    for (int y = 0; y < g->rows; y++) memset(g->obstacles[y], 0, (size_t)g->cols);
+    int count = (g->rows - 2) * (g->cols - 2) * pct / 100;
+
+    for (int i = 0; i < count; i++) {
+        int x, y;
+        do {
+            x = 1 + rand() % (g->cols - 2);
+            y = 1 + rand() % (g->rows - 2);
+        } while ((x == 1 && y == 1) || g->obstacles[y][x]);
+
+        g->obstacles[y][x] = 1;
+        if (connected(g) < 0) g->obstacles[y][x] = 0;
+    }
+}
+
+static int count_obstacles(const GameState* g) {
+    int n = 0;
+    for (int y = 1; y < g->rows - 1; y++)
+        for (int x = 1; x < g->cols - 1; x++) n += g->obstacles[y][x];
+    return n;
+}
+
+static GameState g;
+
+static int run(int rows, int cols, int pct) {
+    int inner = (rows - 2) * (cols - 2);
+    int bad = 0;
+    long placed = 0;
+    long long ns = 0;
+
+    for (int r = 0; r < REPS; r++) {
+        long long t0 = bench_now_ns();
+        game_init(&g, WORLD_WALLS, MODE_STANDARD, 0, rows, cols, pct);
+        ns += bench_now_ns() - t0;
+        placed += count_obstacles(&g);
+        if (connected(&g) < 0) bad++;
+        game_destroy(&g);
+    }
+    double init_us = (double)ns / REPS / 1e3;
+
+    /* povodny sposob pre porovnanie (mriezky z game_init bez prekazok) */
+    char legacy[32] = "-";
+    if (inner <= LEGACY_MAX_CELLS) {
+        game_init(&g, WORLD_WALLS, MODE_STANDARD, 0, rows, cols, 0);
+        long long t0 = bench_now_ns();
+        for (int r = 0; r < REPS; r++) legacy_obstacles(&g, pct);
+        snprintf(legacy, sizeof(legacy), "%.1f", (double)(bench_now_ns() - t0) / REPS / 1e3);
+        game_destroy(&g);
+    }
+
+    printf("%5dx%-5d %3d%% %12.1f %14s %10.1f%%  %s\n",
+           rows, cols, pct, init_us, legacy,
+           100.0 * placed / REPS / inner, bad ? "NESUVISLA!" : "ok");
+    return bad;
+}
+
+int main(void) {
+    static const int sizes[][2] = { { 30, 60 }, { 200, 400 }, { 1000, 1000 }, { 2000, 2000 } };
+    static const int pcts[] = { 4, 20 };
+
+    printf("bench_obstacles: game_init s prekazkami (priemer z %d)\n", REPS);
+    printf("%11s %4s %12s %14s %11s\n", "mapa", "obs", "init us", "povodne us", "prekazky");
+
+    int err = 0;
+    for (int i = 0; i < 4; i++)
+        for (int j = 0; j < 2; j++) err |= run(sizes[i][0], sizes[i][1], pcts[j]);
+    return err;
+}
@@ -0,0 +1,190 @@
+/*
+ * Cena skladania mapy a plneho ramca za tick: povodne game_render_map
+ * (vycistit board, steny, prechod cez vsetky prekazky, vsetci hadi, kopia
+ * po znakoch) a hlavicka cez snprintf oproti sablone hry, ktoru udrzuje
+ * game_step (kopia + prepisanie par bajtov).
+ *
+ * Kazdy tick sa mapa zo sablony porovna s povodnym prekreslenim odznova -
+ * z pohladu hraca aj divaka, v klasickej hre aj v arene, aj pocas pauzy.
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "../Common/protocol.h"
+#include "bench_util.h"
+
+#define TICKS 20000
+#define ARENA_PLAYERS 8
+
+static char legacy[VIEW_ROWS][VIEW_COLS];    // mapy v benchi su cele vo vyreze
+
+/* Povodne game_compose_board: vsetko odznova do legacy */
+static void legacy_compose(const GameState* g, int viewer) {
+    for (int y = 0; y < g->rows; y++)
+        for (int x = 0; x < g->cols; x++)
+            legacy[y][x] = ' ';
+
+    char horiz = g->world == WORLD_WALLS ? '_' : '#';
+    char vert = g->world == WORLD_WALLS ? '|' : '#';
+    for (int x = 0; x < g->cols; x++) {
+        legacy[0][x] = horiz;
+        legacy[g->rows - 1][x] = horiz;
+    }
+    for (int y = 0; y < g->rows; y++) {
+        legacy[y][0] = vert;
+        legacy[y][g->cols - 1] = vert;
+    }
+
+    if (g->has_obstacles) {
+        for (int y = 1; y < g->rows - 1; y++)
+            for (int x = 1; x < g->cols - 1; x++)
+                if (g->obstacles[y][x]) legacy[y][x] = '#';
+    }
+
+    for (int p = 0; p < g->max_players && !g->won; p++) {
+        const Player* pl = &g->players[p];
+        if (!pl->active || (viewer != VIEWER_SPECTATOR && p != viewer)) continue;
+        if (pl->fruit.x >= 0) legacy[pl->fruit.y][pl->fruit.x] = 'o';
+    }
+
+    for (int p = 0; p < g->max_players; p++) {
+        const Snake* s = &g->players[p].snake;
+        if (!g->players[p].active) continue;
+        int k = s->head;
+        for (int i = 0; i < s->len; i++) {
+            legacy[s->parts[k].y][s->parts[k].x] =
+                i == 0 ? (p == viewer ? '@' : 'X') : (p == viewer ? '*' : '+');
+            if (++k == s->cap) k = 0;
+        }
+    }
+}
+
+/* Povodne game_render_map: kopia po znakoch s kontrolou bufferu */
+static int legacy_render(const GameState* g, int viewer, char* out, int out_cap) {
+    legacy_compose(g, viewer);
+
+    int n = snprintf(out, out_cap, "MAP\n");
+    if (g->paused) n += snprintf(out + n, out_cap - n, "=== PAUSED (ESC to resume) ===\n");
+    for (int y = 0; y < g->rows; y++) {
+        for (int x = 0; x < g->cols; x++) {
+            if (n >= out_cap - 2) break;
+            out[n++] = legacy[y][x];
+        }
+        if (n < out_cap - 1) out[n++] = '\n';
+    }
+    n += snprintf(out + n, out_cap - n, "ENDMAP\n");
+    return n;
+}
+
+/* Povodny plny ramec (build_full): SCORE, MODE, TIME cez snprintf + mapa */
+static int legacy_frame(const GameState* g, int score, int time_sec, char* out, int out_cap) {
+    int n = snprintf(out, out_cap, "%s %d\n", CMD_SCORE, score);
+    n += snprintf(out + n, out_cap - n, "MODE %s\n",
+                  g->game_mode == MODE_STANDARD ? "STANDARD" : "TIMED");
+    n += snprintf(out + n, out_cap - n, "%s %ds%s\n", CMD_TIME, time_sec,
+                  g->game_mode == MODE_TIMED ? " LEFT" : "");
+    return n + legacy_render(g, 0, out + n, out_cap - n);
+}
+
+/* Ramce sa zhoduju: rovnake cisla SCORE/TIME a text od MAP po koniec */
+static int frame_differs(const char* a, int na, const char* b, int nb) {
+    int sa, sb, ta, tb;
+    const char* ma = strstr(a, CMD_MAP "\n");
+    const char* mb = strstr(b, CMD_MAP "\n");
+    if (sscanf(a, CMD_SCORE " %d\nMODE %*s\n" CMD_TIME " %d", &sa, &ta) != 2 ||
+        sscanf(b, CMD_SCORE " %d\nMODE %*s\n" CMD_TIME " %d", &sb, &tb) != 2 ||
+        !ma || !mb) return 1;
+    return sa != sb || ta != tb || na - (ma - a) != nb - (mb - b) ||
+           memcmp(ma, mb, (size_t)(na - (ma - a))) != 0;
+}
+
+static int board_differs(GameState* g, int viewer) {
+    game_compose_board(g, viewer);
+    legacy_compose(g, viewer);
+    for (int y = 0; y < g->rows; y++) {
+        if (memcmp(legacy[y], g->board[y], (size_t)g->cols) != 0) return 1;
+    }
+    return 0;
+}
+
+static void new_game(GameState* g, int arena, GameMode mode, int rows, int cols) {
+    if (!arena) {
+        game_init(g, WORLD_WRAP, mode, 60, rows, cols, OBSTACLE_PCT);
+        return;
+    }
+    game_init_arena(g, WORLD_WRAP, rows, cols, OBSTACLE_PCT, ARENA_PLAYERS);
+    for (int p = 0; p < ARENA_PLAYERS; p++) game_join(g);
+}
+
+static int run(int arena, GameMode mode, int rows, int cols) {
+    static GameState g;
+    static char out[8192], ref[8192];
+    long long map_old = 0, map_new = 0, frame_old = 0, frame_new = 0;
+    int bad = 0;
+
+    new_game(&g, arena, mode, rows, cols);
+    for (int t = 0; t < TICKS; t++) {
+        /* obcas pauza (banner v MAP) */
+        if (t % 500 == 100) game_pause(&g);
+        if (t % 500 == 105) game_resume(&g);
+
+        for (int p = 0; p < g.max_players; p++) {
+            if (g.players[p].active && g.players[p].snake.alive) bench_autopilot(&g, p);
+        }
+        game_step(&g);
+
+        /* arena: vypadnuty hrac sa vrati */
+        for (int p = 0; arena && p < g.max_players; p++) {
+            if (g.players[p].active && !g.players[p].snake.alive) {
+                game_leave(&g, p);
+                game_join(&g);
+            }
+        }
+
+        long long t0 = bench_now_ns();
+        int n_old = legacy_render(&g, 0, ref, (int)sizeof(ref));
+        long long t1 = bench_now_ns();
+        int n_new = game_render_map(&g, 0, out, (int)sizeof(out));
+        long long t2 = bench_now_ns();
+        map_old += t1 - t0;
+        map_new += t2 - t1;
+        if (n_old != n_new || memcmp(ref, out, (size_t)n_new) != 0) bad++;
+
+        int score = g.players[0].score, time_sec = (int)(game_elapsed_ms(&g) / 1000);
+        MapView view = { 0, 0, g.rows, g.cols };
+        t0 = bench_now_ns();
+        n_old = legacy_frame(&g, score, time_sec, ref, (int)sizeof(ref));
+        t1 = bench_now_ns();
+        n_new = game_render_frame(&g, 0, &view, score, time_sec, out, (int)sizeof(out));
+        t2 = bench_now_ns();
+        frame_old += t1 - t0;
+        frame_new += t2 - t1;
+        bad += frame_differs(ref, n_old, out, n_new);
+
+        bad += board_differs(&g, VIEWER_SPECTATOR);
+        if (arena) bad += board_differs(&g, t % ARENA_PLAYERS);
+
+        if (!g.running) {
+            game_destroy(&g);
+            new_game(&g, arena, mode, rows, cols);
+        }
+    }
+    game_destroy(&g);
+
+    printf("%-6s %3dx%-3d  mapa %7.1f -> %5.1f ns (%4.1fx)  ramec FULL %7.1f -> %5.1f ns (%4.1fx)  %s\n",
+           arena ? "arena" : mode == MODE_TIMED ? "TIMED" : "hra", rows, cols,
+           (double)map_old / TICKS, (double)map_new / TICKS, (double)map_old / map_new,
+           (double)frame_old / TICKS, (double)frame_new / TICKS, (double)frame_old / frame_new,
+           bad ? "NESEDI!" : "ok");
+    return bad;
+}
+
+int main(void) {
+    srand(1);
+    printf("bench_render: povodne -> sablona hry za tick, %d tickov\n", TICKS);
+    int bad = run(0, MODE_STANDARD, 20, 40);
+    bad += run(0, MODE_TIMED, 20, 40);
+    bad += run(0, MODE_STANDARD, 30, 60);
+    bad += run(1, MODE_STANDARD, 30, 60);
+    return bad != 0;
+}
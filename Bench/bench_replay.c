@@ -0,0 +1,185 @@
+/*
+ * Zaznam a replay hier (gamelog): hry bezia cez Session ako na serveri
+ * (MOVE/PAUSE/RESUME/QUIT cez frontu prikazov, zaznam do suboru), potom sa
+ * kazda prehra headless a koniec sa musi zhodovat so zaznamom aj so stavom
+ * povodnej hry. Meria sa rychlost replay oproti realnemu casu.
+ *
+ * Hrac sa rozhoduje vlastnym generatorom (mimo hry), bench je tak zopakovatelny.
+ *
+ * Navyse zapis + nacitanie zaznamu s kazdym rozdielom tickov 0..MAX_GAP medzi
+ * prikazmi (napr. 69 = bajt 'E') - nacitane prikazy a koniec sa musia zhodovat.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../Common/protocol.h"
+#include "session.h"
+#include "gamelog.h"
+#include "bench_util.h"
+
+#define GAMES 50
+#define MAX_TICKS 4000      // potom QUIT
+#define TICK_MS 150
+#define REPEAT 20           // kolkokrat sa kazdy zaznam prehra pri merani
+#define MAX_GAP 300         // najvacsi rozdiel tickov v teste zapisu
+
+static GameState g, rg;
+static Session s;
+static char paths[GAMES][256];
+static uint32_t final_hash[GAMES];
+
+static unsigned lcg = 12345;
+static unsigned next_rand(void) {
+    lcg = lcg * 1103515245u + 12345u;
+    return lcg >> 16;
+}
+
+/* Smer, ktorym had hned nenarazi (vacsinou doterajsi, obcas nahodna zmena) */
+static char pick_dir(const GameState* gs) {
+    static const char dirs[] = "wasd";
+    static const int dx[] = { 0, -1, 0, 1 };
+    static const int dy[] = { -1, 0, 1, 0 };
+    const Snake* sn = &gs->players[0].snake;
+    int start = (int)(next_rand() % 4);
+    int keep = next_rand() % 8 != 0;
+
+    for (int k = 0; k < 5; k++) {
+        int d;
+        if (k == 0) {
+            if (!keep) continue;
+            d = (int)(strchr(dirs, sn->dir) - dirs);
+        }
+        else {
+            d = (start + k) % 4;
+        }
+        int x = snake_head(sn).x + dx[d];
+        int y = snake_head(sn).y + dy[d];
+        if (gs->world == WORLD_WRAP) {
+            if (x <= 0) x = gs->cols - 2; else if (x >= gs->cols - 1) x = 1;
+            if (y <= 0) y = gs->rows - 2; else if (y >= gs->rows - 1) y = 1;
+        }
+        if (x > 0 && x < gs->cols - 1 && y > 0 && y < gs->rows - 1 &&
+            !gs->obstacles[y][x] && !gs->occupied[y][x]) return dirs[d];
+    }
+    return sn->dir;
+}
+
+/* Jedna hra cez Session so zaznamom, vrati pocet tickov */
+static int record_game(const char* dir, int i) {
+    static const char* starts[] = {
+        CMD_START " 30 60 WRAP OBS STANDARD",
+        CMD_START " 20 40 WALLS NOOBS STANDARD",
+        CMD_START " 25 50 WALLS OBS STANDARD",
+    };
+
+    memset(&g, 0, sizeof(g));
+    session_init(&s, -1, &g);
+    s.record_dir = dir;
+    s.tick_ms = TICK_MS;
+    session_handle_command(&s, starts[i % 3]);
+
+    int ticks = 0;
+    while (s.state != STATE_GAMEOVER) {
+        char cmd[16];
+        if (ticks == MAX_TICKS) session_handle_command(&s, CMD_QUIT);
+        else if (ticks % 300 == 100) session_handle_command(&s, CMD_PAUSE);
+        else if (ticks % 300 == 104) session_handle_command(&s, CMD_RESUME);
+        else {
+            /* MOVE len pri zmene smeru, ako klient */
+            char d = pick_dir(&g);
+            if (d != g.players[0].snake.dir) {
+                snprintf(cmd, sizeof(cmd), "%s %c", CMD_MOVE, d);
+                session_handle_command(&s, cmd);
+            }
+        }
+        session_tick(&s);
+        session_flush(&s);
+        ticks++;
+    }
+
+    snprintf(paths[i], sizeof(paths[i]), "%s", s.record_path);
+    final_hash[i] = gamelog_hash(&g);
+    game_destroy(&g);
+    return ticks;
+}
+
+/* Zapis a nacitanie: prikaz po kazdom rozdiele 0..MAX_GAP, potom koniec. Vrati pocet chyb */
+static int roundtrip(const char* dir) {
+    static const char cmds[] = "wasdPRQ";
+    char path[300];
+    snprintf(path, sizeof(path), "%s/roundtrip.snlog", dir);
+
+    game_init_seeded(&g, WORLD_WALLS, MODE_STANDARD, 0, 20, 40, 0, 1);
+    GameLogWriter w;
+    if (gamelog_open(&w, path, &g, TICK_MS) < 0) { game_destroy(&g); return 1; }
+
+    unsigned tick = 0;
+    for (int d = 0; d <= MAX_GAP; d++) {
+        tick += (unsigned)d;
+        gamelog_cmd(&w, tick, cmds[d % 7]);
+    }
+    unsigned end_tick = tick + 69;
+    gamelog_end(&w, end_tick, 1, &g);
+    uint32_t hash = gamelog_hash(&g);
+    game_destroy(&g);
+
+    GameLog log;
+    if (gamelog_load(&log, path) < 0) { unlink(path); return 1; }
+    unlink(path);
+
+    int bad = log.ncmds != MAX_GAP + 1 || !log.has_end || log.end.tick != end_tick ||
+              !log.end.stopped || log.end.hash != hash;
+    tick = 0;
+    for (int d = 0; d <= MAX_GAP && d < log.ncmds; d++) {
+        tick += (unsigned)d;
+        if (log.cmds[d].tick != tick || log.cmds[d].cmd != cmds[d % 7]) bad++;
+    }
+    gamelog_free(&log);
+    return bad;
+}
+
+int main(void) {
+    char dir[] = "/tmp/bench_replay_XXXXXX";
+    if (!mkdtemp(dir)) { perror("mkdtemp"); return 1; }
+
+    long long rec_ticks = 0;
+    for (int i = 0; i < GAMES; i++) rec_ticks += record_game(dir, i);
+
+    int bad = 0;
+    long long ticks = 0, ns = 0, bytes = 0;
+    long cmds = 0;
+    for (int i = 0; i < GAMES; i++) {
+        GameLog log;
+        if (gamelog_load(&log, paths[i]) < 0) { bad++; continue; }
+
+        FILE* f = fopen(paths[i], "rb");
+        if (f) { fseek(f, 0, SEEK_END); bytes += ftell(f); fclose(f); }
+        cmds += log.ncmds;
+
+        ReplayResult r;
+        int match = 0;
+        long long t0 = bench_now_ns();
+        for (int k = 0; k < REPEAT; k++) match = gamelog_replay(&log, &rg, &r);
+        ns += bench_now_ns() - t0;
+        ticks += (long long)r.ticks * REPEAT;
+
+        if (match != 1 || r.hash != final_hash[i]) bad++;
+        gamelog_free(&log);
+        unlink(paths[i]);
+    }
+    int rt_bad = roundtrip(dir);
+    rmdir(dir);
+
+    printf("bench_replay: %d hier, %lld tickov, %ld prikazov, zaznam %.1f B/hru (%.2f B/prikaz)\n",
+           GAMES, rec_ticks, cmds, (double)bytes / GAMES, cmds ? (double)bytes / cmds : 0.0);
+    printf("replay %.1f ns/tick, %.0fx rychlejsie ako realny cas (tick %d ms), zhoda %s\n",
+           (double)ns / ticks, (double)ticks * TICK_MS * 1e6 / ns, TICK_MS,
+           bad ? "NESEDI!" : "ok");
+    printf("zapis/nacitanie: rozdiely tickov 0..%d medzi prikazmi %s\n", MAX_GAP,
+           rt_bad ? "NESEDI!" : "ok");
+    return bad != 0 || rt_bad != 0;
+}
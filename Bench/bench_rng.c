@@ -0,0 +1,159 @@
+/*
+ * Nahoda pri viacerych hrach naraz: globalny rand() (jeden stav so zamkom
+ * v libc) oproti generatoru v kazdej hre (GameRng). Meria sa pri 1..8
+ * vlaknach, kazde vlakno ma vlastne hry ako Loop v manager serveri:
+ *   - holy generator: rand() oproti rng_next
+ *   - nova hra s prekazkami (game_init + game_destroy)
+ *   - ovocie: game_join + game_leave v arene (novy had = nove ovocie)
+ *
+ * Overuje sa, ze rovnaky seed da rovnaku mapu aj ovocie a ze dve hry
+ * zalozene hned po sebe dostanu rozny seed.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "bench_util.h"
+
+#define MAX_THREADS 8
+#define RAND_CALLS 2000000
+#define INITS 2000
+#define JOINS 200000
+
+typedef enum { T_RAND, T_RNG, T_INIT, T_FRUIT, TESTS } Test;
+
+static const char* test_names[TESTS] = {
+    "rand() M/s", "GameRng M/s", "nova hra k/s", "ovocie k/s"
+};
+
+typedef struct {
+    Test test;
+    int id;
+    long long ops;
+    unsigned sink;
+} Worker;
+
+static void* worker(void* arg) {
+    Worker* w = arg;
+    unsigned sink = 0;
+
+    switch (w->test) {
+    case T_RAND:
+        for (int i = 0; i < RAND_CALLS; i++) sink += (unsigned)rand();
+        w->ops = RAND_CALLS;
+        break;
+    case T_RNG: {
+        GameRng r;
+        rng_seed(&r, 42, (uint64_t)w->id);
+        for (int i = 0; i < RAND_CALLS; i++) sink += rng_next(&r);
+        w->ops = RAND_CALLS;
+        break;
+    }
+    case T_INIT: {
+        GameState* g = calloc(1, sizeof(*g));
+        if (!g) { perror("calloc"); exit(1); }
+        for (int i = 0; i < INITS; i++) {
+            game_init(g, WORLD_WALLS, MODE_STANDARD, 0, 30, 60, OBSTACLE_PCT);
+            sink += (unsigned)g->players[0].fruit.x;
+            game_destroy(g);
+        }
+        free(g);
+        w->ops = INITS;
+        break;
+    }
+    case T_FRUIT: {
+        GameState* g = calloc(1, sizeof(*g));
+        if (!g) { perror("calloc"); exit(1); }
+        game_init_arena(g, WORLD_WRAP, 30, 60, OBSTACLE_PCT, 8);
+        for (int i = 0; i < JOINS; i++) {
+            int p = game_join(g);
+            if (p < 0) continue;
+            sink += (unsigned)g->players[p].fruit.x;
+            game_leave(g, p);
+        }
+        game_destroy(g);
+        free(g);
+        w->ops = JOINS;
+        break;
+    }
+    default:
+        break;
+    }
+    w->sink = sink;
+    return NULL;
+}
+
+/* Operacie za sekundu pri n vlaknach (spolu) */
+static double run(Test test, int n) {
+    pthread_t th[MAX_THREADS];
+    Worker w[MAX_THREADS];
+
+    long long t0 = bench_now_ns();
+    for (int i = 0; i < n; i++) {
+        w[i] = (Worker){ .test = test, .id = i };
+        pthread_create(&th[i], NULL, worker, &w[i]);
+    }
+    long long ops = 0;
+    for (int i = 0; i < n; i++) {
+        pthread_join(th[i], NULL);
+        ops += w[i].ops;
+    }
+    long long ns = bench_now_ns() - t0;
+    return (double)ops * 1e9 / ns;
+}
+
+/* Rovnaky seed -> rovnake prekazky a ovocie, game_init -> rozne seedy */
+static int check(void) {
+    static GameState a, b;
+    int bad = 0;
+
+    for (unsigned seed = 1; seed <= 50; seed++) {
+        game_init_seeded(&a, WORLD_WALLS, MODE_STANDARD, 0, 30, 60, OBSTACLE_PCT, seed);
+        game_init_seeded(&b, WORLD_WALLS, MODE_STANDARD, 0, 30, 60, OBSTACLE_PCT, seed);
+        for (int y = 0; y < a.rows; y++) {
+            if (memcmp(a.obstacles[y], b.obstacles[y], (size_t)a.cols) != 0) bad++;
+        }
+        if (a.players[0].fruit.x != b.players[0].fruit.x ||
+            a.players[0].fruit.y != b.players[0].fruit.y) bad++;
+        game_destroy(&a);
+        game_destroy(&b);
+    }
+
+    for (int i = 0; i < 50; i++) {
+        game_init(&a, WORLD_WALLS, MODE_STANDARD, 0, 30, 60, OBSTACLE_PCT);
+        game_init(&b, WORLD_WALLS, MODE_STANDARD, 0, 30, 60, OBSTACLE_PCT);
+        if (a.seed == b.seed) bad++;
+        game_destroy(&a);
+        game_destroy(&b);
+    }
+    return bad;
+}
+
+int main(void) {
+    static const int threads[] = { 1, 2, 4, 8 };
+    const int nthreads = (int)(sizeof(threads) / sizeof(threads[0]));
+
+    printf("bench_rng: mapa 30x60, prekazky %d%%\n", OBSTACLE_PCT);
+    printf("%-14s", "vlakna");
+    for (int i = 0; i < nthreads; i++) printf("%10d", threads[i]);
+    printf("\n");
+
+    for (int t = 0; t < TESTS; t++) {
+        double base = 0, v = 0;
+        double scale = t == T_RAND || t == T_RNG ? 1e6 : 1e3;
+        printf("%-14s", test_names[t]);
+        for (int i = 0; i < nthreads; i++) {
+            v = run((Test)t, threads[i]);
+            if (i == 0) base = v;
+            printf("%10.1f", v / scale);
+        }
+        printf("   (%d vlakien = %.2fx 1 vlakna)\n", threads[nthreads - 1], v / base);
+    }
+
+    int bad = check();
+    printf("seed: zopakovatelnost a rozne seedy %s\n", bad ? "NESEDI!" : "ok");
+    return bad != 0;
+}
@@ -0,0 +1,139 @@
+/*
+ * Diff renderer klienta (Client/screen.c): kolko bajtov ide na terminal
+ * za ramec oproti povodnemu clear screen + cela obrazovka.
+ *
+ * Hra bezi na autopilotovi, obrazovka ma hlavicku s UTF-8 ramcekom ako
+ * klient, obcas banner pauzy (iny pocet riadkov) a obcas prekreslenie
+ * odznova. Vystup sa prehra v jednoduchom emulatore terminalu a po kazdom
+ * ramci sa obsah emulatora musi zhodovat s tym, co sa malo zobrazit.
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "screen.h"
+#include "bench_util.h"
+
+#define TICKS 20000
+#define VT_ROWS SCR_ROWS
+#define VT_COLS 256
+
+/* Emulator: bunka = jeden znak (1-4 bajty UTF-8) */
+static char vt[VT_ROWS][VT_COLS][4];
+static int vt_row, vt_col;
+
+static void vt_clear(int row, int col_from, int row_to) {
+    for (int y = row; y < row_to && y < VT_ROWS; y++) {
+        for (int x = y == row ? col_from : 0; x < VT_COLS; x++) memset(vt[y][x], 0, 4);
+    }
+}
+
+static void vt_feed(const char* p, int n) {
+    for (int i = 0; i < n; i++) {
+        unsigned char c = (unsigned char)p[i];
+        if (c == 27 && i + 1 < n && p[i + 1] == '[') {
+            int a = 0, b = 0, semi = 0, j = i + 2;
+            while (j < n && ((p[j] >= '0' && p[j] <= '9') || p[j] == ';')) {
+                if (p[j] == ';') semi = 1;
+                else if (semi) b = b * 10 + (p[j] - '0');
+                else a = a * 10 + (p[j] - '0');
+                j++;
+            }
+            if (p[j] == 'H') { vt_row = a ? a - 1 : 0; vt_col = b ? b - 1 : 0; }
+            else if (p[j] == 'K') vt_clear(vt_row, vt_col, vt_row + 1);
+            else if (p[j] == 'J') vt_clear(vt_row, vt_col, VT_ROWS);
+            i = j;
+        }
+        else if (c == '\r') vt_col = 0;
+        else if (c == '\n') vt_row++;
+        else if ((c & 0xC0) == 0x80) {
+            /* pokracovanie UTF-8 znaku v predchadzajucej bunke */
+            char* cell = vt[vt_row][vt_col - 1];
+            int k = 0;
+            while (k < 4 && cell[k]) k++;
+            if (k < 4) cell[k] = (char)c;
+        }
+        else {
+            memset(vt[vt_row][vt_col], 0, 4);
+            vt[vt_row][vt_col][0] = (char)c;
+            vt_col++;
+        }
+    }
+}
+
+/* Riadok emulatora ako bajty, prazdne bunky = medzera, bez medzier na konci */
+static int vt_line(int y, char* out) {
+    int n = 0, end = 0;
+    for (int x = 0; x < VT_COLS; x++) {
+        const char* cell = vt[y][x];
+        if (!cell[0]) { out[n++] = ' '; continue; }
+        for (int k = 0; k < 4 && cell[k]; k++) out[n++] = cell[k];
+        end = n;
+    }
+    return end;
+}
+
+static int screen_matches(const Screen* s) {
+    char line[VT_COLS * 4];
+    for (int y = 0; y < VT_ROWS; y++) {
+        int n = vt_line(y, line);
+        int len = y < s->back.nlines ? s->back.len[y] : 0;
+        while (len > 0 && s->back.text[y][len - 1] == ' ') len--;
+        if (n != len || memcmp(line, s->back.text[y], (size_t)n) != 0) return 0;
+    }
+    return 1;
+}
+
+static GameState g;
+static Screen scr;
+static char out[SCR_OUT_CAP];
+
+int main(void) {
+    game_init(&g, WORLD_WRAP, MODE_STANDARD, 0, 30, 60, OBSTACLE_PCT);
+
+    long long full_bytes = 0, diff_bytes = 0, ns = 0;
+    int bad = 0, games = 1;
+
+    for (int t = 0; t < TICKS; t++) {
+        if (!g.running) {
+            game_destroy(&g);
+            game_init(&g, WORLD_WRAP, MODE_STANDARD, 0, 30, 60, OBSTACLE_PCT);
+            games++;
+        }
+        bench_autopilot(&g, 0);
+        game_step(&g);
+        game_compose_board(&g, 0);
+
+        /* obcas cudzi vystup (menu) - prekreslenie odznova */
+        if (t % 1000 == 999) scr_invalidate(&scr);
+
+        long long t0 = bench_now_ns();
+        scr_begin(&scr);
+        scr_line(&scr, "╔════════════════════════════════════════════════════════════╗");
+        scr_line(&scr, "║  REZIM: %-10s │ SKORE: %-5d │ CAS: %-15s ║",
+                 "STANDARD", g.players[0].score, t % 7 ? "12s" : "13s");
+        scr_line(&scr, "╚════════════════════════════════════════════════════════════╝");
+        if ((t / 50) % 4 == 3) scr_line(&scr, "=== PAUSED (ESC to resume) ===");
+        for (int y = 0; y < g.rows; y++) scr_text(&scr, g.board[y], g.cols);
+        scr_line(&scr, "tty: %5d B/ramec", scr.last_bytes);
+        int n = scr_diff(&scr, out);
+        ns += bench_now_ns() - t0;
+
+        scr.last_bytes = n;
+        diff_bytes += n;
+
+        /* povodne: clear + vsetky riadky s '\n' */
+        full_bytes += 6;
+        for (int y = 0; y < scr.back.nlines; y++) full_bytes += scr.back.len[y] + 1;
+
+        vt_feed(out, n);
+        if (!screen_matches(&scr)) bad++;
+    }
+    game_destroy(&g);
+
+    printf("bench_screen: 30x60, %d ramcov (%d hier)\n", TICKS, games);
+    printf("clear + cela obrazovka %7.0f B/ramec\n", (double)full_bytes / TICKS);
+    printf("diff renderer          %7.0f B/ramec (%.1fx menej), %.2f us/ramec, emulator %s\n",
+           (double)diff_bytes / TICKS, (double)full_bytes / diff_bytes, ns / 1e3 / TICKS,
+           bad ? "NESEDI!" : "ok");
+    return bad != 0;
+}
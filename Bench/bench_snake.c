@@ -0,0 +1,144 @@
+/*
+ * Mikrobenchmark posunu hada pri roznych dlzkach.
+ *
+ * 1) samotny posun tela: povodne posuvanie pola (O(len))
+ *    oproti kruhovemu bufferu (O(1))
+ * 2) cely game_step (mapa 30x60, pre dlhsie hady 60x80),
+ *    had nasleduje Hamiltonovsku kruznicu
+ * 3) zaplnenie celej mapy: posledne ovocie sa musi najst hned
+ *    a plna mapa musi skoncit vyhrou (nie zaseknutim v spawn_fruit)
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "bench_util.h"
+
+#define MOVES 2000000
+#define STEPS 50000
+
+// dlzka pola / kapacita kruhoveho buffera (aspon najvacsia meranu dlzka)
+#define BUF_LEN 4096
+
+static Pos arr[BUF_LEN];
+
+/* Povodny posun: kazdy segment o jedno miesto */
+static double shift_ns(int len) {
+    long long t0 = bench_now_ns();
+    for (int m = 0; m < MOVES / 16; m++) {
+        for (int i = len - 1; i > 0; i--) arr[i] = arr[i - 1];
+        arr[0].x = m;
+    }
+    return (double)(bench_now_ns() - t0) / (MOVES / 16);
+}
+
+/* Kruhovy buffer: posun hlavy a chvosta */
+static Snake ring;
+static Pos ring_parts[BUF_LEN];
+
+static double ring_ns(int len) {
+    Snake* s = &ring;
+    memset(s, 0, sizeof(*s));
+    s->parts = ring_parts;
+    s->cap = BUF_LEN;
+    s->len = len;
+    s->head = 0;
+    s->tail = len - 1;
+
+    /* sucet chvostov, aby kompilator slucku nevyhodil */
+    long long sum = 0;
+    long long t0 = bench_now_ns();
+    for (int m = 0; m < MOVES; m++) {
+        s->head = s->head == 0 ? s->cap - 1 : s->head - 1;
+        s->parts[s->head].x = m;
+        sum += s->parts[s->tail].x;
+        s->tail = s->tail == 0 ? s->cap - 1 : s->tail - 1;
+    }
+    double ns = (double)(bench_now_ns() - t0) / MOVES;
+    if (sum == -1) printf("?\n");
+    return ns;
+}
+
+/*
+ * game_step pri dlzke hada aspon len na mape rows x cols. Pocas merania had
+ * dalej rastie, preto dlzky drzime pod plnou mapou (po zaplneni hra konci).
+ * *bad = had nedorastol na len alebo occupied[] nesedi s telom.
+ */
+static double step_ns(int len, int rows, int cols, int* real_len, int* bad) {
+    GameState g;
+    game_init(&g, WORLD_WRAP, MODE_STANDARD, 0, rows, cols, 0);
+
+    /* dorast: had ide po kruznici a zjeda ovocie */
+    while (g.players[0].snake.len < len && g.running) {
+        bench_follow_cycle(&g);
+        game_step(&g);
+    }
+
+    int steps = 0;
+    long long t0 = bench_now_ns();
+    for (; steps < STEPS && g.running; steps++) {
+        bench_follow_cycle(&g);
+        game_step(&g);
+    }
+    double ns = (double)(bench_now_ns() - t0) / (steps ? steps : 1);
+
+    /* occupied[] musi presne zodpovedat telu hada */
+    int cells = 0;
+    for (int y = 0; y < g.rows; y++)
+        for (int x = 0; x < g.cols; x++) cells += g.occupied[y][x];
+    for (int i = 0; i < g.players[0].snake.len; i++) {
+        Pos p = snake_part(&g.players[0].snake, i);
+        if (!g.occupied[p.y][p.x]) cells = -1;
+    }
+    *real_len = g.players[0].snake.len;
+    *bad = cells != *real_len || *real_len < len;
+    game_destroy(&g);
+    return ns;
+}
+
+/* Had ide po kruznici, kym nezaplni mapu. Vrati 0 ak vsetko sedi. */
+static int fill_board(int rows, int cols) {
+    GameState g;
+    game_init(&g, WORLD_WRAP, MODE_STANDARD, 0, rows, cols, 0);
+
+    int inner = (g.rows - 2) * (g.cols - 2);
+    long steps = 0;
+    long long t0 = bench_now_ns();
+    while (g.running && steps < 100000000L) {
+        bench_follow_cycle(&g);
+        game_step(&g);
+        steps++;
+    }
+    double ms = (double)(bench_now_ns() - t0) / 1e6;
+
+    int ok = g.won && g.players[0].snake.len == inner && g.free_count == 0;
+    printf("fill %dx%d: %ld krokov, %.1f ms (%.1f ns/krok), dlzka %d/%d, %s\n",
+           g.rows, g.cols, steps, ms, ms * 1e6 / steps, g.players[0].snake.len, inner,
+           ok ? "vyhra" : "CHYBA");
+
+    game_destroy(&g);
+    return ok ? 0 : 1;
+}
+
+int main(void) {
+    /* dlzka, mapa pre game_step (dlhsi had sa na 30x60 nezmesti) */
+    static const int lens[][3] = { { 3, 30, 60 }, { 256, 30, 60 }, { 1000, 30, 60 },
+                                   { 4000, 60, 80 } };
+
+    printf("bench_snake: posun tela (shift = povodne pole, ring = kruhovy buffer)\n");
+    printf("%6s %12s %12s %16s\n", "len", "shift ns", "ring ns", "game_step ns");
+
+    int err = 0;
+    for (int i = 0; i < 4; i++) {
+        int len = lens[i][0], real_len = 0, bad;
+        double st = step_ns(len, lens[i][1], lens[i][2], &real_len, &bad);
+        printf("%6d %12.2f %12.2f %16.1f  (mapa %dx%d, dlzka pri merani %d)  %s\n",
+               len, shift_ns(len), ring_ns(len), st, lens[i][1], lens[i][2], real_len,
+               bad ? "CHYBA" : "ok");
+        err |= bad;
+    }
+
+    err |= fill_board(20, 40);
+    err |= fill_board(30, 60);
+    err |= fill_board(40, 80);      // had dlhsi ako 1800 (povodne pevne pole tela)
+    return err;
+}
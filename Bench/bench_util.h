@@ -0,0 +1,81 @@
+#pragma once
+/*
+ * Spolocne pomocky pre benchmarky (headless, bez siete).
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "game.h"
+
+static inline long long bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/*
+ * Jednoduchy "hrac" p: drzi smer (keep) alebo skusa smery od start (0..3)
+ * a vyhyba sa policku, kde by hned narazil (stena, prekazka, had - podla
+ * occupied[]). Nahodu dodava volajuci.
+ */
+static inline void bench_steer(GameState* g, int p, int start, int keep) {
+    static const char dirs[] = "wasd";
+    static const int dx[] = { 0, -1, 0, 1 };
+    static const int dy[] = { -1, 0, 1, 0 };
+    const Snake* s = &g->players[p].snake;
+
+    for (int k = 0; k < 5; k++) {
+        int d;
+        if (k == 0) {
+            if (!keep) continue;
+            d = (int)(strchr(dirs, s->dir) - dirs);
+        }
+        else {
+            d = (start + k) % 4;
+        }
+
+        int x = snake_head(s).x + dx[d];
+        int y = snake_head(s).y + dy[d];
+        if (g->world == WORLD_WRAP) {
+            if (x <= 0) x = g->cols - 2; else if (x >= g->cols - 1) x = 1;
+            if (y <= 0) y = g->rows - 2; else if (y >= g->rows - 1) y = 1;
+        }
+        if (x > 0 && x < g->cols - 1 && y > 0 && y < g->rows - 1 &&
+            !g->obstacles[y][x] && !g->occupied[y][x]) {
+            game_set_dir(g, p, dirs[d]);
+            if (s->dir == dirs[d]) return;
+        }
+    }
+}
+
+/* bench_steer s nahodou z rand(): obcas zmeni smer (len jedno vlakno) */
+static inline void bench_autopilot(GameState* g, int p) {
+    int start = rand() % 4;
+    int keep = rand() % 8 != 0;
+    bench_steer(g, p, start, keep);
+}
+
+/*
+ * Smer po Hamiltonovskej kruznici cez vnutro mapy (vyzaduje parny pocet
+ * vnutornych riadkov). Had, ktory ju nasleduje, nikdy nenarazi a postupne
+ * zje vsetko ovocie - takto sa da dosiahnut lubovolna dlzka hada.
+ *
+ *   riadok 1: doprava az po posledny stlpec, potom dole
+ *   riadky 2..H: had (serpentina) cez stlpce 2..W
+ *   stlpec 1: hore spat do riadku 1
+ */
+static inline char bench_cycle_dir(const GameState* g, int x, int y) {
+    int W = g->cols - 2;
+    int H = g->rows - 2;
+
+    if (y == 1) return x < W ? 'd' : 's';
+    if (x == 1) return 'w';
+    if (y % 2 == 0) return x > 2 ? 'a' : (y == H ? 'a' : 's');
+    return x < W ? 'd' : 's';
+}
+
+static inline void bench_follow_cycle(GameState* g) {
+    Pos h = snake_head(&g->players[0].snake);
+    game_set_dir(g, 0, bench_cycle_dir(g, h.x, h.y));
+}
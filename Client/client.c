@@ -1,3 +1,5 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -6,8 +8,13 @@
 #include <pthread.h>
 #include <termios.h>
 #include <signal.h>
+#include <errno.h>
+#include <poll.h>
+#include <time.h>
 
 #include "../Common/protocol.h"
+#include "screen.h"
+#include "latency.h"
 
 #define BUFFER_SIZE 4096
 
@@ -15,6 +22,19 @@ static int sock;
 static volatile int running = 1;
 static int score = 0;
 
+// format ramcov, ktory si klient vyziada v START (FULL/DELTA/BINARY)
+static const char* frame_format = FRAMES_BINARY;
+
+// -a: START s tokenom ARENA (spolocna arena na serveri -m)
+static int join_arena = 0;
+
+// -p: jedno vlakno s poll nad stdin a socketom namiesto input/render threadov
+static int poll_mode = 0;
+
+// latencia klavesa -> obrazovka za cely beh klienta, pri skonceni ide do suboru (-l)
+static Latency lat;
+static const char* lat_path = "client_latency.csv";
+
 
 // TERMINAL
 static struct termios old_termios;
@@ -31,46 +51,73 @@ static void disable_raw_mode(void) {
     tcsetattr(STDIN_FILENO, TCSANOW, &old_termios);
 }
 
+// herna obrazovka: kresli sa len rozdiel oproti predchadzajucemu ramcu
+static Screen screen;
+
+/*
+ * Ked terminal nestiha, klient kresli len najnovsi ramec (latest-frame-wins).
+ * lag = kolko ramcov v poslednom kresleni uz cakalo za sebou (0 = stihame).
+ */
+static struct {
+    long frames;        // prijate ramce
+    long skipped;       // prijate, ale nenakreslene (hned za nimi bol novsi)
+    int lag;
+    double draw_ms;     // trvanie posledneho zapisu na terminal
+} render_stats;
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
 static void clear_screen(void) {
     (void)write(STDOUT_FILENO, "\033[H\033[J", 6);
+    scr_invalidate(&screen);
 }
 
 
+// INPUT
+static int paused = 0;  // lokalny flag pre toggle pauzy
+
+/*
+ * Jedna klavesa -> prikaz pre server, pripoji sa do out.
+ * Vrati pocet pridanych bajtov (0 = klavesa nic nerobi). 'q' zastavi hru.
+ * MOVE dostane seq pre meranie latencie, po send treba zavolat lat_sent.
+ */
+static int key_command(char c, char* out, int cap) {
+    if (c == 'q') {
+        running = 0;
+        return snprintf(out, cap, "%s\n", CMD_QUIT);
+    }
+
+    // ESC (kod 27) - prepinanie pauzy
+    if (c == 27) {
+        paused = !paused;
+        return snprintf(out, cap, "%s\n", paused ? CMD_PAUSE : CMD_RESUME);
+    }
+
+    if (c == 'w' || c == 'a' || c == 's' || c == 'd') {
+        return snprintf(out, cap, "%s %c %u\n", CMD_MOVE, c, lat_key(&lat, now_ms()));
+    }
+    return 0;
+}
+
 // INPUT THREAD
 static void* input_thread(void* arg) {
     (void)arg;  // unused
     char c;
     char msg[32];
-    static int paused = 0;  // lokalny flag pre toggle pauzy
 
     enable_raw_mode();
 
     while (running) {
-        if (read(STDIN_FILENO, &c, 1) <= 0)
-            continue;
+        int r = (int)read(STDIN_FILENO, &c, 1);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) break;  /* stdin zavrety - nic dalsie nepride, netocime sa naprazdno */
 
-        if (c == 'q') {
-            send(sock, CMD_QUIT "\n", strlen(CMD_QUIT) + 1, 0);
-            running = 0;
-            break;
-        }
-
-        // ESC (kod 27) - prepinanie pauzy
-        if (c == 27) {
-            if (paused) {
-                send(sock, CMD_RESUME "\n", strlen(CMD_RESUME) + 1, 0);
-                paused = 0;
-            } else {
-                send(sock, CMD_PAUSE "\n", strlen(CMD_PAUSE) + 1, 0);
-                paused = 1;
-            }
-            continue;
-        }
-
-        if (c == 'w' || c == 'a' || c == 's' || c == 'd') {
-            snprintf(msg, sizeof(msg), "%s %c\n", CMD_MOVE, c);
-            send(sock, msg, strlen(msg), 0);
-        }
+        int n = key_command(c, msg, sizeof(msg));
+        if (n > 0 && send(sock, msg, n, 0) > 0) lat_sent(&lat, now_ms());
     }
 
     disable_raw_mode();
@@ -79,89 +126,409 @@ static void* input_thread(void* arg) {
 
 // tato cast bola vytvorena pomocou AI
 // RENDER THREAD
-static void* render_thread(void* arg) {
-    (void)arg;  // unused
-    char recvbuf[BUFFER_SIZE];
-    char frame[BUFFER_SIZE * 2];
-    int frame_len = 0;
-    char time_str[32] = "0s";
-    char mode_str[32] = "STANDARD";
 
-    while (running) {
-        int n = recv(sock, recvbuf, sizeof(recvbuf) - 1, 0);
-        if (n <= 0) break;
+/*
+ * Model mapy na strane klienta. Plny ramec (MAP ... ENDMAP) ho prepise,
+ * DELTA ramec zmeni len uvedene policka.
+ */
+#define VIEW_MAX_ROWS 64
+#define VIEW_MAX_COLS 128
+
+typedef struct {
+    char rows[VIEW_MAX_ROWS][VIEW_MAX_COLS + 1];
+    int nrows;
+    char banner[64];        // napr. "=== PAUSED ... ===" (je v MAP pred mapou)
+    char time_str[32];
+    char mode_str[32];
+    int game_over;
+    int won;                // GAME_OVER: had zaplnil mapu
+    char error[128];        // ERROR od servera (napr. prilis velka mapa)
+} View;
 
-        memcpy(frame + frame_len, recvbuf, n);
-        frame_len += n;
-        frame[frame_len] = '\0';
+/*
+ * Ramec sa slozi do screen a na terminal ide len rozdiel oproti
+ * predchadzajucemu (presuny kurzora + zmenene znaky, jeden write).
+ * Posledny riadok ukazuje, kolko bajtov isiel na tty posledny ramec,
+ * ako dlho trval zapis a ci terminal nestiha (LAG).
+ */
+static void draw_view(const View* v) {
+    scr_begin(&screen);
+
+    // Zobraz header s informaciami o hre
+    scr_line(&screen, "╔════════════════════════════════════════════════════════════╗");
+    scr_line(&screen, "║  REZIM: %-10s │ SKORE: %-5d │ CAS: %-15s ║",
+             v->mode_str, score, v->time_str);
+    scr_line(&screen, "╚════════════════════════════════════════════════════════════╝");
+    if (v->banner[0]) scr_line(&screen, "%s", v->banner);
+
+    for (int y = 0; y < v->nrows; y++) {
+        scr_text(&screen, v->rows[y], (int)strlen(v->rows[y]));
+    }
 
-        /* SCORE */
-        char* s = strstr(frame, CMD_SCORE);
-        if (s) {
-            sscanf(s + strlen(CMD_SCORE), "%d", &score);
-        }
+    scr_line(&screen, "tty: %5d B/ramec (priemer %.0f), zapis %.1f ms, preskocene %ld%s",
+             screen.last_bytes, screen.frames ? (double)screen.bytes / screen.frames : 0.0,
+             render_stats.draw_ms, render_stats.skipped,
+             render_stats.lag > 0 ? "  << LAG: terminal nestiha" : "");
+
+    double t0 = now_ms();
+    scr_flush(&screen, STDOUT_FILENO);
+    render_stats.draw_ms = now_ms() - t0;
+}
+
+static void draw_game_over(const View* v) {
+    clear_screen();
+    printf("\n");
+    printf("╔════════════════════════════════════════════════════════════╗\n");
+    if (v->error[0]) {
+        printf("║                   SERVER ODMIETOL HRU                      ║\n");
+    }
+    else if (v->won) {
+        printf("║                  VYHRA - PLNA MAPA!                        ║\n");
+    }
+    else {
+        printf("║                        GAME OVER                           ║\n");
+    }
+    printf("╠════════════════════════════════════════════════════════════╣\n");
+    printf("║  Rezim: %-20s                            ║\n", v->mode_str);
+    printf("║  Finalne skore: %-5d                                    ║\n", score);
+    printf("║  Cas: %-20s                               ║\n", v->time_str);
+    if (v->error[0]) printf("║  %-58.58s║\n", v->error);
+    printf("╠════════════════════════════════════════════════════════════╣\n");
+    printf("║         Stlac Enter pre navrat do menu...                  ║\n");
+    printf("╚════════════════════════════════════════════════════════════╝\n");
+    printf("  tty: %ld ramcov, priemer %.0f B/ramec, preskocene %ld z %ld prijatych\n",
+           screen.frames, screen.frames ? (double)screen.bytes / screen.frames : 0.0,
+           render_stats.skipped, render_stats.frames);
+    if (lat.count[LAT_TOTAL] > 0) {
+        printf("  klavesa->obrazovka: p50 %.1f ms p99 %.1f ms (server fronta p50 %.1f ms, "
+               "send->prijaty p50 %.1f ms)\n",
+               lat_percentile(&lat, LAT_TOTAL, 50), lat_percentile(&lat, LAT_TOTAL, 99),
+               lat_percentile(&lat, LAT_SERVER_QUEUE, 50), lat_percentile(&lat, LAT_SEND_RX, 50));
+    }
+    printf("\n");
+}
 
-        /* MODE - parsuj pred TIME */
-        char* m = strstr(frame, "MODE ");
-        if (m && m < frame + frame_len - 10) {
-            sscanf(m + 5, "%31s", mode_str);
+typedef enum { PARSE_HEADER, PARSE_MAP, PARSE_DELTA } ParseState;
+
+/*
+ * Spracuje jeden riadok od servera.
+ * Vrati 1 ked je ramec kompletny (treba ho vykreslit), inak 0.
+ */
+static int handle_line(View* v, ParseState* ps, int* map_row, const char* line) {
+    /* hlavicka (moze byt aj vo vnutri DELTA) */
+    if (*ps != PARSE_MAP) {
+        if (strncmp(line, CMD_SCORE " ", strlen(CMD_SCORE) + 1) == 0) {
+            sscanf(line + strlen(CMD_SCORE), "%d", &score);
+            return 0;
         }
+        if (strncmp(line, CMD_TIME " ", strlen(CMD_TIME) + 1) == 0) {
+            if (sscanf(line + strlen(CMD_TIME) + 1, "%31s", v->time_str) != 1) {
+                strcpy(v->time_str, "N/A");
+            }
+            return 0;
+        }
+    }
 
-        /* TIME - hladaj "\nTIME " aby sme nenasli TIME vo vnutri TIMED */
-        char* map_start = strstr(frame, CMD_MAP);
-        char* t = strstr(frame, "\nTIME ");
-        if (t && (!map_start || t < map_start)) {
-            // Parsuje cas (preskocime \n a "TIME")
-            if (sscanf(t + 6, "%31s", time_str) != 1) {
-                strcpy(time_str, "N/A");
+    switch (*ps) {
+    case PARSE_HEADER:
+        if (strcmp(line, CMD_GAME_OVER) == 0) {
+            v->game_over = 1;
+        }
+        else if (strncmp(line, CMD_ERROR " ", strlen(CMD_ERROR) + 1) == 0) {
+            /* server hru odmietol, ziadna mapa uz nepride */
+            snprintf(v->error, sizeof(v->error), "%s", line + strlen(CMD_ERROR) + 1);
+            v->game_over = 1;
+            return 1;
+        }
+        else if (strcmp(line, CMD_WIN) == 0) {
+            v->won = 1;
+        }
+        else if (strncmp(line, CMD_ACK " ", strlen(CMD_ACK) + 1) == 0) {
+            unsigned seq, tick, wait_us;
+            if (sscanf(line + strlen(CMD_ACK) + 1, "%u %u %u", &seq, &tick, &wait_us) == 3) {
+                lat_ack(&lat, seq, tick, wait_us, now_ms());
             }
         }
+        else if (strncmp(line, "MODE ", 5) == 0) {
+            sscanf(line + 5, "%31s", v->mode_str);
+        }
+        else if (strcmp(line, CMD_MAP) == 0) {
+            *ps = PARSE_MAP;
+            *map_row = 0;
+            v->banner[0] = '\0';
+        }
+        else if (strncmp(line, CMD_DELTA " ", strlen(CMD_DELTA) + 1) == 0) {
+            *ps = PARSE_DELTA;
+        }
+        return 0;
 
-        /* GAME OVER */
-        if (strstr(frame, CMD_GAME_OVER)) {
-            clear_screen();
-            printf("\n");
-            printf("╔════════════════════════════════════════════════════════════╗\n");
-            printf("║                        GAME OVER                           ║\n");
-            printf("╠════════════════════════════════════════════════════════════╣\n");
-            printf("║  Rezim: %-20s                            ║\n", mode_str);
-            printf("║  Finalne skore: %-5d                                    ║\n", score);
-            printf("║  Cas: %-20s                               ║\n", time_str);
-            printf("╠════════════════════════════════════════════════════════════╣\n");
-            printf("║         Stlac Enter pre navrat do menu...                  ║\n");
-            printf("╚════════════════════════════════════════════════════════════╝\n");
-            printf("\n");
-            running = 0;
-            break;
+    case PARSE_MAP:
+        if (strcmp(line, "ENDMAP") == 0) {
+            *ps = PARSE_HEADER;
+            if (!v->game_over) v->nrows = *map_row;
+            return 1;
+        }
+        if (strncmp(line, "===", 3) == 0) {
+            snprintf(v->banner, sizeof(v->banner), "%s", line);
+        }
+        else if (*map_row < VIEW_MAX_ROWS) {
+            snprintf(v->rows[*map_row], VIEW_MAX_COLS + 1, "%s", line);
+            (*map_row)++;
         }
+        return 0;
 
-        /* MAP */
-        char* m1 = strstr(frame, CMD_MAP "\n");
-        char* m2 = strstr(frame, "ENDMAP\n");
+    case PARSE_DELTA:
+        if (strcmp(line, CMD_ENDDELTA) == 0) {
+            *ps = PARSE_HEADER;
+            return 1;
+        }
+        /* policko: <znak> <x> <y> */
+        int x, y;
+        if (line[0] && sscanf(line + 1, "%d %d", &x, &y) == 2 &&
+            y >= 0 && y < v->nrows && x >= 0 && x < (int)strlen(v->rows[y])) {
+            v->rows[y][x] = line[0];
+        }
+        return 0;
+    }
+    return 0;
+}
 
-        if (m1 && m2) {
-            m1 += strlen(CMD_MAP) + 1;
-            clear_screen();
-            
-            // Zobraz header s informaciami o hre
-            printf("╔════════════════════════════════════════════════════════════╗\n");
-            printf("║  REZIM: %-10s │ SKORE: %-5d │ CAS: %-15s ║\n", 
-                   mode_str, score, time_str);
-            printf("╚════════════════════════════════════════════════════════════╝\n");
-            
-            (void)write(STDOUT_FILENO, m1, m2 - m1);
-            fflush(stdout);
+/*
+ * Prijate bajty zo socketu, ktore este netvoria cely ramec.
+ * rx_next_frame spracuje najblizsi kompletny ramec, takze ho moze
+ * pouzit blokujuci render thread aj poll loop.
+ */
+typedef struct {
+    unsigned char buf[FRAME_HDR_SIZE + VIEW_MAX_ROWS * VIEW_MAX_COLS * 2];
+    int len;
+    int pos;            // uz spracovane bajty v buf
+    ParseState ps;      // textove ramce: kde v ramci sme
+    int map_row;
+    int error;          // chybny binarny ramec - spojenie nema zmysel citat dalej
+} Rx;
+
+/* Precita zo socketu co sa zmesti do buf. Vrati vysledok recv */
+static int rx_recv(Rx* rx, int flags) {
+    if (rx->pos > 0) {
+        memmove(rx->buf, rx->buf + rx->pos, rx->len - rx->pos);
+        rx->len -= rx->pos;
+        rx->pos = 0;
+    }
+    /* riadok dlhsi ako buffer - zahodime */
+    if (rx->len >= (int)sizeof(rx->buf) - 1) rx->len = 0;
 
-            int used = (m2 + strlen("ENDMAP\n")) - frame;
-            memmove(frame, frame + used, frame_len - used);
-            frame_len -= used;
+    int n = recv(sock, rx->buf + rx->len, sizeof(rx->buf) - 1 - rx->len, flags);
+    if (n > 0) rx->len += n;
+    return n;
+}
+
+/* Textove ramce (FULL/DELTA): riadok po riadku, 1 = ramec je kompletny */
+static int rx_next_text(View* view, Rx* rx) {
+    unsigned char* nl;
+    while ((nl = memchr(rx->buf + rx->pos, '\n', rx->len - rx->pos)) != NULL) {
+        *nl = '\0';
+        int done = handle_line(view, &rx->ps, &rx->map_row, (const char*)rx->buf + rx->pos);
+        rx->pos = (int)(nl - rx->buf) + 1;
+        if (done) return 1;
+    }
+    return 0;
+}
+
+/*
+ * Spracuje jeden binarny ramec (hlavicka + payload).
+ * Vrati 1 ked treba prekreslit.
+ */
+static int handle_bin_frame(View* v, const FrameHeader* h, const unsigned char* p) {
+    /* potvrdenie MOVE, nasleduje ramec s jeho vysledkom */
+    if (h->type == FRAME_ACK) {
+        if (h->len >= FRAME_ACK_SIZE) {
+            lat_ack(&lat, get_u32(p), get_u32(p + 4), get_u32(p + 8), now_ms());
         }
+        return 0;
+    }
+
+    score = h->score;
+    snprintf(v->time_str, sizeof(v->time_str), "%ds", (int)h->time_sec);
+    strcpy(v->mode_str, (h->flags & FRAME_F_TIMED) ? "TIMED" : "STANDARD");
+    strcpy(v->banner, (h->flags & FRAME_F_PAUSED) ? "=== PAUSED (ESC to resume) ===" : "");
+
+    switch (h->type) {
+    case FRAME_KEY: {
+        int rows = h->rows < VIEW_MAX_ROWS ? h->rows : VIEW_MAX_ROWS;
+        int cols = h->cols < VIEW_MAX_COLS ? h->cols : VIEW_MAX_COLS;
+        if (h->len < (uint32_t)h->rows * h->cols) return 0;
+        for (int y = 0; y < rows; y++) {
+            memcpy(v->rows[y], p + (size_t)y * h->cols, cols);
+            v->rows[y][cols] = '\0';
+        }
+        v->nrows = rows;
+        return 1;
+    }
+    case FRAME_DELTA:
+        for (uint32_t i = 0; i + FRAME_CELL_SIZE <= h->len; i += FRAME_CELL_SIZE) {
+            int x = get_u16(p + i);
+            int y = get_u16(p + i + 2);
+            if (y < v->nrows && x < (int)strlen(v->rows[y])) v->rows[y][x] = (char)p[i + 4];
+        }
+        return 1;
+    case FRAME_GAME_OVER:
+        v->game_over = 1;
+        v->won = (h->flags & FRAME_F_WIN) != 0;
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+/* Binarne ramce: pevna hlavicka + payload, bez hladania v texte */
+static int rx_next_binary(View* view, Rx* rx) {
+    /* ERROR ide textom aj v binarnom rezime */
+    if (rx->len - rx->pos >= (int)strlen(CMD_ERROR) &&
+        memcmp(rx->buf + rx->pos, CMD_ERROR, strlen(CMD_ERROR)) == 0) {
+        return rx_next_text(view, rx);
+    }
+    while (rx->len - rx->pos >= FRAME_HDR_SIZE) {
+        FrameHeader h;
+        frame_hdr_unpack(rx->buf + rx->pos, &h);
+
+        /* chybny alebo prilis velky ramec */
+        if (h.magic != FRAME_MAGIC || h.len > sizeof(rx->buf) - FRAME_HDR_SIZE) {
+            rx->error = 1;
+            return 0;
+        }
+        if ((uint32_t)(rx->len - rx->pos) < FRAME_HDR_SIZE + h.len) break; /* pocka na zvysok */
+
+        int draw = handle_bin_frame(view, &h, rx->buf + rx->pos + FRAME_HDR_SIZE);
+        rx->pos += FRAME_HDR_SIZE + (int)h.len;
+        if (draw) return 1;
+    }
+    return 0;
+}
+
+/* Najblizsi kompletny ramec z rx do view, 1 = treba prekreslit */
+static int rx_next_frame(View* view, Rx* rx) {
+    if (strcmp(frame_format, FRAMES_BINARY) == 0) return rx_next_binary(view, rx);
+    return rx_next_text(view, rx);
+}
+
+/*
+ * Spracuje vsetky kompletne ramce v rx aj vsetko, co uz caka v sockete
+ * (MSG_DONTWAIT). Kazdy ramec sa aplikuje na model (delty sa nesmu
+ * vynechat), nakresli sa az posledny stav. Vrati pocet kompletnych ramcov,
+ * *closed = spojenie skoncilo alebo prisiel chybny ramec.
+ */
+static int rx_drain(View* view, Rx* rx, int* closed) {
+    int frames = 0;
+    *closed = 0;
+
+    while (1) {
+        while (rx_next_frame(view, rx)) {
+            frames++;
+            if (view->game_over) return frames;
+        }
+        if (rx->error) {
+            *closed = 1;
+            return frames;
+        }
+
+        int r = rx_recv(rx, MSG_DONTWAIT);
+        if (r > 0) continue;
+        if (r == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) *closed = 1;
+        return frames;
+    }
+}
+
+/* Nakresli najnovsi stav po rx_drain, starsie ramce z tej istej davky sa preskocia */
+static void present(const View* view, int frames) {
+    if (frames == 0) return;
+
+    render_stats.frames += frames;
+    render_stats.skipped += frames - 1;
+    render_stats.lag = frames - 1;
+
+    if (view->game_over) {
+        draw_game_over(view);
+        return;
+    }
+    draw_view(view);
+    lat_drawn(&lat, now_ms());
+}
+
+static void view_init(View* view) {
+    memset(view, 0, sizeof(*view));
+    strcpy(view->time_str, "0s");
+    strcpy(view->mode_str, "STANDARD");
+}
+
+static void* render_thread(void* arg) {
+    (void)arg;  // unused
+    static View view;
+    static Rx rx;
+
+    view_init(&view);
+    memset(&rx, 0, sizeof(rx));
+
+    /* blokujuci recv caka na data, potom sa vyberie vsetko, co uz prislo */
+    while (running && rx_recv(&rx, 0) > 0) {
+        int closed;
+        present(&view, rx_drain(&view, &rx, &closed));
+        if (view.game_over || closed) break;
     }
 
     running = 0;
     return NULL;
 }
 
+/*
+ * Herna session v jednom vlakne: poll nad stdin a socketom.
+ * Klavesy sa citaju po davkach a idu jednym send hned po precitani,
+ * ramec sa kresli az ked je kompletny. Bez vstupu a ramcov proces spi v poll.
+ */
+static void run_poll_session(void) {
+    static View view;
+    static Rx rx;
+
+    view_init(&view);
+    memset(&rx, 0, sizeof(rx));
+    enable_raw_mode();
+
+    struct pollfd fds[2] = {
+        { .fd = STDIN_FILENO, .events = POLLIN },
+        { .fd = sock, .events = POLLIN }
+    };
+
+    /* po 'q' uz len chvilu cakame na GAME_OVER od servera */
+    int over = 0;
+    while (!over) {
+        int r = poll(fds, 2, running ? -1 : 1000);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) break;
+
+        if (fds[0].revents) {
+            char keys[64];
+            char msg[sizeof(keys) * 16];
+            int n = (int)read(STDIN_FILENO, keys, sizeof(keys));
+            if (n <= 0) fds[0].fd = -1;  /* stdin zavrety - dalej len ramce */
+
+            int len = 0;
+            for (int i = 0; i < n && running; i++) {
+                len += key_command(keys[i], msg + len, (int)sizeof(msg) - len);
+            }
+            if (len > 0 && send(sock, msg, len, 0) > 0) lat_sent(&lat, now_ms());
+            if (!running) fds[0].fd = -1;
+        }
+
+        if (fds[1].revents) {
+            int closed;
+            present(&view, rx_drain(&view, &rx, &closed));
+            if (view.game_over || closed) over = 1;
+        }
+    }
+
+    running = 0;
+    disable_raw_mode();
+}
+
 // MAIN
 /*
 * Zobrazi hlavne menu a vrati volbu uzivatela
@@ -250,6 +617,7 @@ static int show_size_menu(int* rows, int* cols) {
     printf("1) Mala (20x40)\n");
     printf("2) Stredna (25x50)\n");
     printf("3) Velka (30x60)\n");
+    printf("4) Svet (1000x1000, vidno vyrez okolo hada)\n");
     printf("0) Spat\n");
     printf("> ");
     fflush(stdout);
@@ -264,6 +632,7 @@ static int show_size_menu(int* rows, int* cols) {
         case 1: *rows = 20; *cols = 40; break;
         case 2: *rows = 25; *cols = 50; break;
         case 3: *rows = 30; *cols = 60; break;
+        case 4: *rows = 1000; *cols = 1000; break;
         default: *rows = 20; *cols = 40;
     }
     return 1;
@@ -311,12 +680,20 @@ static void run_game_session(void) {
     
     running = 1;
     score = 0;
+    paused = 0;
+    memset(&screen, 0, sizeof(screen));
+    memset(&render_stats, 0, sizeof(render_stats));
     
-    pthread_create(&tin, NULL, input_thread, NULL);
-    pthread_create(&tr, NULL, render_thread, NULL);
+    if (poll_mode) {
+        run_poll_session();
+    }
+    else {
+        pthread_create(&tin, NULL, input_thread, NULL);
+        pthread_create(&tr, NULL, render_thread, NULL);
 
-    pthread_join(tin, NULL);
-    pthread_join(tr, NULL);
+        pthread_join(tin, NULL);
+        pthread_join(tr, NULL);
+    }
     
     disable_raw_mode();
     
@@ -330,7 +707,7 @@ static void run_game_session(void) {
     }
 }
 
-int main(void) {
+int main(int argc, char** argv) {
     struct sockaddr_in addr;
     pid_t server_pid = -1;
 
@@ -340,6 +717,31 @@ int main(void) {
     char server_ip[128] = "127.0.0.1";
     int server_port = SERVER_PORT;
 
+    // -f FULL/DELTA/BINARY: format ramcov (default BINARY), -a arena, -p poll loop,
+    // -l FILE: kam zapisat histogramy latencie
+    int opt;
+    while ((opt = getopt(argc, argv, "apf:l:")) != -1) {
+        if (opt == 'a') {
+            join_arena = 1;
+        }
+        else if (opt == 'p') {
+            poll_mode = 1;
+        }
+        else if (opt == 'l') {
+            lat_path = optarg;
+        }
+        else if (opt == 'f' && (strcmp(optarg, FRAMES_FULL) == 0 ||
+                           strcmp(optarg, FRAMES_DELTA) == 0 ||
+                           strcmp(optarg, FRAMES_BINARY) == 0)) {
+            frame_format = optarg;
+        }
+        else {
+            fprintf(stderr, "Pouzitie: %s [-a] [-p] [-f FULL|DELTA|BINARY] [-l FILE]\n", argv[0]);
+            return 1;
+        }
+    }
+    lat_init(&lat);
+
     // MENU LOOP
     while (1) {
         int choice = show_main_menu();
@@ -448,16 +850,17 @@ int main(void) {
                 continue;
             }
             
-            // Posle START prikaz: START <rows> <cols> <walls/wrap> <obstacles> <mode> [time]
+            // Posle START prikaz: START <rows> <cols> <walls/wrap> <obstacles> <mode> [time] [ARENA] <format>
+            const char* arena = join_arena ? START_ARENA " " : "";
             char start_cmd[128];
             if (strcmp(mode_str, "TIMED") == 0) {
-                snprintf(start_cmd, sizeof(start_cmd), "%s %d %d %s %s %s %d\n", 
+                snprintf(start_cmd, sizeof(start_cmd), "%s %d %d %s %s %s %d %s%s\n", 
                          CMD_START, map_rows, map_cols, world, 
-                         has_obstacles ? "OBS" : "NOOBS", mode_str, time_limit);
+                         has_obstacles ? "OBS" : "NOOBS", mode_str, time_limit, arena, frame_format);
             } else {
-                snprintf(start_cmd, sizeof(start_cmd), "%s %d %d %s %s %s\n", 
+                snprintf(start_cmd, sizeof(start_cmd), "%s %d %d %s %s %s %s%s\n", 
                          CMD_START, map_rows, map_cols, world,
-                         has_obstacles ? "OBS" : "NOOBS", mode_str);
+                         has_obstacles ? "OBS" : "NOOBS", mode_str, arena, frame_format);
             }
             send(sock, start_cmd, strlen(start_cmd), 0);
             game_started = 1;
@@ -477,5 +880,10 @@ int main(void) {
         }
     }
 
+    /* histogramy latencie za cely beh */
+    if (lat.count[LAT_KEY_SEND] > 0 && lat_export(&lat, lat_path) == 0) {
+        printf("Latencia ovladania zapisana do %s\n", lat_path);
+    }
+
     return 0;
 }
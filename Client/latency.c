@@ -0,0 +1,128 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "latency.h"
+
+#define MASK (LAT_PENDING - 1)
+
+static const char* stage_names[LAT_STAGES] = {
+    "klavesa_send", "server_fronta", "send_prijaty", "prijaty_nakresleny", "spolu"
+};
+
+void lat_init(Latency* l) {
+    memset(l, 0, sizeof(*l));
+    pthread_mutex_init(&l->mtx, NULL);
+    l->next_seq = 1;    // 0 = MOVE bez seq
+}
+
+static void record(Latency* l, LatStage s, double ms) {
+    double us = ms * 1000.0;
+    int b = 0;
+    while (b < LAT_BUCKETS - 1 && us >= (double)(2L << b)) b++;
+
+    l->hist[s][b]++;
+    l->count[s]++;
+    if (ms > l->max_ms[s]) l->max_ms[s] = ms;
+}
+
+unsigned lat_key(Latency* l, double t) {
+    pthread_mutex_lock(&l->mtx);
+    unsigned seq = l->next_seq++;
+    LatPending* p = &l->pending[seq & MASK];
+    if (p->state != 0) l->lost++;
+    p->seq = seq;
+    p->t_key = t;
+    p->state = 1;
+    pthread_mutex_unlock(&l->mtx);
+    return seq;
+}
+
+void lat_sent(Latency* l, double t) {
+    pthread_mutex_lock(&l->mtx);
+    for (int i = 0; i < LAT_PENDING; i++) {
+        LatPending* p = &l->pending[i];
+        if (p->state != 1) continue;
+        p->t_send = t;
+        p->state = 2;
+        record(l, LAT_KEY_SEND, t - p->t_key);
+    }
+    pthread_mutex_unlock(&l->mtx);
+}
+
+void lat_ack(Latency* l, unsigned seq, unsigned tick, unsigned wait_us, double t) {
+    pthread_mutex_lock(&l->mtx);
+    record(l, LAT_SERVER_QUEUE, wait_us / 1000.0);
+    if (tick == l->last_tick && l->count[LAT_SERVER_QUEUE] > 1) l->same_tick++;
+    l->last_tick = tick;
+
+    for (int i = 0; i < LAT_PENDING; i++) {
+        LatPending* p = &l->pending[i];
+        if (p->state != 2 || (int)(seq - p->seq) < 0) continue;
+        p->t_rx = t;
+        p->state = 3;
+        record(l, LAT_SEND_RX, t - p->t_send);
+    }
+    pthread_mutex_unlock(&l->mtx);
+}
+
+void lat_drawn(Latency* l, double t) {
+    pthread_mutex_lock(&l->mtx);
+    for (int i = 0; i < LAT_PENDING; i++) {
+        LatPending* p = &l->pending[i];
+        if (p->state != 3) continue;
+        record(l, LAT_RX_DRAW, t - p->t_rx);
+        record(l, LAT_TOTAL, t - p->t_key);
+        p->state = 0;
+    }
+    pthread_mutex_unlock(&l->mtx);
+}
+
+/* Horna hranica kosa v ms */
+static double bucket_hi_ms(int b) {
+    return (double)(2L << b) / 1000.0;
+}
+
+double lat_percentile(const Latency* l, LatStage s, double p) {
+    if (l->count[s] == 0) return 0.0;
+
+    long need = (long)(l->count[s] * p / 100.0 + 0.5);
+    if (need < 1) need = 1;
+    long acc = 0;
+    for (int b = 0; b < LAT_BUCKETS; b++) {
+        acc += l->hist[s][b];
+        if (acc < need) continue;
+        /* horna hranica kosa, ale nie viac ako skutocne maximum */
+        double hi = bucket_hi_ms(b);
+        return b == LAT_BUCKETS - 1 || hi > l->max_ms[s] ? l->max_ms[s] : hi;
+    }
+    return l->max_ms[s];
+}
+
+int lat_export(const Latency* l, const char* path) {
+    FILE* f = fopen(path, "w");
+    if (!f) { perror("fopen"); return -1; }
+
+    /* hlavicka: kos v us, potom pocet vzoriek kazdej etapy v kosi */
+    fprintf(f, "od_us,do_us");
+    for (int s = 0; s < LAT_STAGES; s++) fprintf(f, ",%s", stage_names[s]);
+    fprintf(f, "\n");
+
+    for (int b = 0; b < LAT_BUCKETS; b++) {
+        long from = b == 0 ? 0 : 1L << b;
+        if (b == LAT_BUCKETS - 1) fprintf(f, "%ld,", from);
+        else fprintf(f, "%ld,%ld", from, 2L << b);
+        for (int s = 0; s < LAT_STAGES; s++) fprintf(f, ",%ld", l->hist[s][b]);
+        fprintf(f, "\n");
+    }
+
+    /* suhrn ako komentare na konci */
+    for (int s = 0; s < LAT_STAGES; s++) {
+        fprintf(f, "# %s: n=%ld p50=%.3f ms p99=%.3f ms max=%.3f ms\n", stage_names[s],
+                l->count[s], lat_percentile(l, (LatStage)s, 50), lat_percentile(l, (LatStage)s, 99),
+                l->max_ms[s]);
+    }
+    fprintf(f, "# MOVE prepisane v tom istom ticku: %ld, bez ACK: %ld\n", l->same_tick, l->lost);
+
+    fclose(f);
+    return 0;
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <pthread.h>
+
+/*
+ * Latencia ovladania: klavesa -> send -> server aplikuje -> ramec prijaty -> nakresleny.
+ *
+ * Kazdy MOVE ma poradove cislo (MOVE <smer> <seq>), server v ramcoch vracia
+ * posledne aplikovane (ACK <seq> <tick> <cakanie_us>). Vsetky MOVE do seq
+ * vratane su tym potvrdene; ich cas prijatia je cas ACK, cas vykreslenia
+ * najblizsie kreslenie po nom. Casy su v ms podla CLOCK_MONOTONIC klienta,
+ * zo servera sa berie len cakanie prikazu vo fronte (ine hodiny).
+ *
+ * lat_key/lat_sent vola input thread, lat_ack/lat_drawn render thread.
+ */
+#define LAT_PENDING 256         // MOVE na ceste (mocnina 2)
+#define LAT_BUCKETS 24          // kos i = [2^i, 2^(i+1)) us (kos 0 od nuly, posledny bez hornej hranice)
+
+typedef enum {
+    LAT_KEY_SEND,       // klavesa -> send
+    LAT_SERVER_QUEUE,   // prijate serverom -> aplikovane v ticku (zo servera)
+    LAT_SEND_RX,        // send -> ramec s ACK prijaty
+    LAT_RX_DRAW,        // prijaty -> nakresleny
+    LAT_TOTAL,          // klavesa -> nakresleny
+    LAT_STAGES
+} LatStage;
+
+typedef struct {
+    unsigned seq;
+    double t_key, t_send, t_rx;
+    int state;          // 0 volne, 1 klavesa, 2 odoslane, 3 potvrdene
+} LatPending;
+
+typedef struct {
+    pthread_mutex_t mtx;
+    unsigned next_seq;
+    LatPending pending[LAT_PENDING];
+
+    long hist[LAT_STAGES][LAT_BUCKETS];
+    long count[LAT_STAGES];
+    double max_ms[LAT_STAGES];
+
+    unsigned last_tick;
+    long same_tick;     // MOVE aplikovany v tom istom ticku ako predchadzajuci (prepisal ho)
+    long lost;          // MOVE bez ACK (prepisany v pending, alebo spojenie skoncilo)
+} Latency;
+
+void lat_init(Latency* l);
+
+// Klavesa pre MOVE stlacena v case t, vrati seq pre MOVE
+unsigned lat_key(Latency* l, double t);
+
+// Vsetky zatial neodoslane MOVE odisli v case t
+void lat_sent(Latency* l, double t);
+
+// Server aplikoval vsetky MOVE do seq (tick, cakanie vo fronte), ACK prisiel v case t
+void lat_ack(Latency* l, unsigned seq, unsigned tick, unsigned wait_us, double t);
+
+// Nakreslilo sa v case t (uzavrie potvrdene MOVE)
+void lat_drawn(Latency* l, double t);
+
+// Percentil p (0..100) etapy v ms (horna hranica kosa, najviac max), 0 bez vzoriek
+double lat_percentile(const Latency* l, LatStage s, double p);
+
+// Zapise histogramy (CSV) do path, vrati 0 alebo -1
+int lat_export(const Latency* l, const char* path);
@@ -0,0 +1,527 @@
+/*
+ * Zatazovy generator: simuluje vela hracov naraz, bez terminalu.
+ *
+ * Otvori N spojeni, kazde posle START a potom MOVE s danou frekvenciou.
+ * Prijate ramce sa parsuju a kontroluju (text aj binarne), meria sa cas
+ * nadviazania spojenia, rozptyl intervalov medzi ramcami (jitter voci
+ * perioda ticku), priepustnost a chyby. Po konci hry sa spojenie
+ * znovu otvori, takze pocet hracov ostava N.
+ * S -W su spojenia divaci (WATCH): len prijimaju a kontroluju ramce areny.
+ *
+ * Vsetky spojenia obsluhuje par epoll vlakien (nie vlakno na hraca).
+ * Server treba spustit v multi-session rezime (server -m).
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <arpa/inet.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+
+#include "../Common/protocol.h"
+
+#define MAX_EVENTS 256
+#define IN_CAP 16384
+#define LINE_MAX_LEN 512
+
+// histogram jitteru: kose po 0.1 ms do 1 s, posledny kos = viac
+#define JIT_BUCKET_NS 100000LL
+#define JIT_BUCKETS 10001
+
+typedef enum {
+    C_IDLE,         // nepripojene (cakame na znovupripojenie)
+    C_CONNECTING,
+    C_RUNNING
+} ConnState;
+
+typedef enum {
+    P_HEADER,
+    P_MAP,
+    P_DELTA
+} TextState;
+
+typedef struct {
+    int fd;
+    ConnState state;
+    long long connect_start;
+    long long last_frame;       // cas posledneho celeho ramca (0 = ziadny)
+    long long next_move;
+
+    unsigned char in[IN_CAP];
+    int in_len;
+
+    /* kontrola ramcov */
+    TextState ts;
+    int rows, cols;             // rozmery mapy z prveho keyframe
+    int map_rows;
+    int delta_left;
+    int game_over;
+} Conn;
+
+typedef struct {
+    long connects;
+    long connect_fail;
+    long long connect_ns_sum;
+    long long connect_ns_max;
+    long games;
+    long frames;
+    long long bytes;
+    long moves;
+    long errors;                // chybny ramec
+    long closed;                // server zavrel spojenie pred GAME_OVER
+    long jit[JIT_BUCKETS];
+    long long jit_max;
+} Stats;
+
+typedef struct {
+    int id;
+    pthread_t th;
+    int epfd;
+    Conn* conns;
+    int count;
+    unsigned seed;          // rand_r pre smery MOVE
+    Stats st;
+} Worker;
+
+/* nastavenia (z prikazoveho riadku, po spusteni len na citanie) */
+static struct sockaddr_in server_addr;
+static char start_cmd[256];
+static const char* frame_format = FRAMES_BINARY;
+static int binary;
+static int watch;                   // divaci namiesto hracov
+static double move_rate = 5.0;      // MOVE za sekundu na hraca
+static long long tick_ns = 150000000LL;
+static long long end_ns;
+
+static long long now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void conn_close(Worker* w, Conn* c) {
+    if (c->fd >= 0) {
+        epoll_ctl(w->epfd, EPOLL_CTL_DEL, c->fd, NULL);
+        close(c->fd);
+    }
+    c->fd = -1;
+    c->state = C_IDLE;
+}
+
+static void conn_open(Worker* w, Conn* c) {
+    memset(c, 0, sizeof(*c));
+    c->fd = -1;
+    c->state = C_IDLE;
+
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    if (fd < 0) { w->st.connect_fail++; return; }
+
+    c->fd = fd;
+    c->connect_start = now_ns();
+    if (connect(fd, (struct sockaddr*)&server_addr, sizeof(server_addr)) < 0 &&
+        errno != EINPROGRESS) {
+        close(fd);
+        c->fd = -1;
+        w->st.connect_fail++;
+        return;
+    }
+
+    c->state = C_CONNECTING;
+    struct epoll_event ev = { .events = EPOLLOUT, .data.ptr = c };
+    if (epoll_ctl(w->epfd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        conn_close(w, c);
+        w->st.connect_fail++;
+    }
+}
+
+static int conn_send(Conn* c, const char* msg) {
+    size_t len = strlen(msg);
+    return send(c->fd, msg, len, MSG_NOSIGNAL | MSG_DONTWAIT) == (ssize_t)len;
+}
+
+/* Spojenie je nadviazane: START a odteraz citame ramce */
+static void conn_connected(Worker* w, Conn* c) {
+    int err = 0;
+    socklen_t len = sizeof(err);
+    getsockopt(c->fd, SOL_SOCKET, SO_ERROR, &err, &len);
+    if (err != 0) {
+        conn_close(w, c);
+        w->st.connect_fail++;
+        return;
+    }
+
+    long long t = now_ns() - c->connect_start;
+    w->st.connects++;
+    w->st.connect_ns_sum += t;
+    if (t > w->st.connect_ns_max) w->st.connect_ns_max = t;
+
+    struct epoll_event ev = { .events = EPOLLIN, .data.ptr = c };
+    epoll_ctl(w->epfd, EPOLL_CTL_MOD, c->fd, &ev);
+
+    c->state = C_RUNNING;
+    c->next_move = move_rate > 0 ? now_ns() + (long long)(1e9 / move_rate) : 0;
+    if (!conn_send(c, start_cmd)) {
+        conn_close(w, c);
+        w->st.connect_fail++;
+    }
+}
+
+/* Cely ramec prijaty: interval oproti predchadzajucemu */
+static void on_frame(Worker* w, Conn* c) {
+    long long t = now_ns();
+    w->st.frames++;
+
+    if (c->last_frame) {
+        long long d = (t - c->last_frame) - tick_ns;
+        if (d < 0) d = -d;
+        long b = (long)(d / JIT_BUCKET_NS);
+        w->st.jit[b < JIT_BUCKETS ? b : JIT_BUCKETS - 1]++;
+        if (d > w->st.jit_max) w->st.jit_max = d;
+    }
+    c->last_frame = t;
+}
+
+/* Jeden textovy riadok (FULL/DELTA). Vrati -1 pri chybe. */
+static int text_line(Worker* w, Conn* c, const char* line) {
+    switch (c->ts) {
+    case P_HEADER:
+        if (strcmp(line, CMD_GAME_OVER) == 0) { c->game_over = 1; return 0; }
+        if (strcmp(line, CMD_WIN) == 0) return 0;
+        if (strncmp(line, CMD_SCORE " ", strlen(CMD_SCORE) + 1) == 0) return 0;
+        if (strncmp(line, CMD_TIME " ", strlen(CMD_TIME) + 1) == 0) return 0;
+        if (strncmp(line, "MODE ", 5) == 0) return 0;
+        if (strcmp(line, CMD_MAP) == 0) {
+            c->ts = P_MAP;
+            c->map_rows = 0;
+            return 0;
+        }
+        if (strncmp(line, CMD_DELTA " ", strlen(CMD_DELTA) + 1) == 0) {
+            if (!c->rows) return -1;  /* delta bez keyframe */
+            c->delta_left = atoi(line + strlen(CMD_DELTA) + 1);
+            c->ts = P_DELTA;
+            return 0;
+        }
+        return -1;
+
+    case P_MAP:
+        if (strcmp(line, "ENDMAP") == 0) {
+            c->ts = P_HEADER;
+            if (c->game_over) return 0;
+            if (!c->rows) c->rows = c->map_rows;   /* prvy keyframe */
+            if (c->map_rows != c->rows) return -1;
+            on_frame(w, c);
+            return 0;
+        }
+        if (c->game_over || strncmp(line, "===", 3) == 0) return 0;
+
+        /* rozmery si zapamatame z prveho keyframe, dalej musia sediet */
+        if (c->map_rows == 0 && !c->rows) c->cols = (int)strlen(line);
+        if ((int)strlen(line) != c->cols) return -1;
+        c->map_rows++;
+        return 0;
+
+    case P_DELTA:
+        if (strcmp(line, CMD_ENDDELTA) == 0) {
+            c->ts = P_HEADER;
+            if (c->delta_left != 0) return -1;
+            on_frame(w, c);
+            return 0;
+        }
+        if (strncmp(line, CMD_SCORE " ", strlen(CMD_SCORE) + 1) == 0) return 0;
+        if (strncmp(line, CMD_TIME " ", strlen(CMD_TIME) + 1) == 0) return 0;
+        {
+            int x, y;
+            if (!line[0] || sscanf(line + 1, "%d %d", &x, &y) != 2) return -1;
+            if (x < 0 || x >= c->cols || y < 0 || y >= c->rows) return -1;
+            c->delta_left--;
+        }
+        return 0;
+    }
+    return -1;
+}
+
+/* Spracuje text v bufferi po celych riadkoch. Vrati -1 pri chybe. */
+static int parse_text(Worker* w, Conn* c) {
+    int start = 0;
+    while (1) {
+        unsigned char* nl = memchr(c->in + start, '\n', (size_t)(c->in_len - start));
+        if (!nl) break;
+        *nl = '\0';
+
+        const char* line = (const char*)c->in + start;
+        start = (int)(nl - c->in) + 1;
+
+        if (text_line(w, c, line) < 0) return -1;
+        if (c->game_over) break;
+    }
+
+    memmove(c->in, c->in + start, (size_t)(c->in_len - start));
+    c->in_len -= start;
+    if (c->in_len >= LINE_MAX_LEN && !memchr(c->in, '\n', (size_t)c->in_len)) return -1;
+    return 0;
+}
+
+/* Binarne ramce: kontrola hlavicky a obsahu. Vrati -1 pri chybe. */
+static int parse_binary(Worker* w, Conn* c) {
+    int pos = 0;
+    while (c->in_len - pos >= FRAME_HDR_SIZE) {
+        FrameHeader h;
+        frame_hdr_unpack(c->in + pos, &h);
+
+        if (h.magic != FRAME_MAGIC || h.len > IN_CAP - FRAME_HDR_SIZE) return -1;
+        if ((uint32_t)(c->in_len - pos) < FRAME_HDR_SIZE + h.len) break;
+
+        const unsigned char* p = c->in + pos + FRAME_HDR_SIZE;
+        switch (h.type) {
+        case FRAME_KEY:
+            if (h.len != (uint32_t)h.rows * h.cols) return -1;
+            c->rows = h.rows;
+            c->cols = h.cols;
+            on_frame(w, c);
+            break;
+        case FRAME_DELTA:
+            if (!c->rows || h.len % FRAME_CELL_SIZE != 0) return -1;
+            if (h.rows != c->rows || h.cols != c->cols) return -1;
+            for (uint32_t i = 0; i < h.len; i += FRAME_CELL_SIZE) {
+                if (get_u16(p + i) >= c->cols || get_u16(p + i + 2) >= c->rows) return -1;
+            }
+            on_frame(w, c);
+            break;
+        case FRAME_GAME_OVER:
+            c->game_over = 1;
+            break;
+        default:
+            return -1;
+        }
+        pos += FRAME_HDR_SIZE + (int)h.len;
+        if (c->game_over) break;
+    }
+
+    memmove(c->in, c->in + pos, (size_t)(c->in_len - pos));
+    c->in_len -= pos;
+    return 0;
+}
+
+static void conn_read(Worker* w, Conn* c) {
+    while (c->state == C_RUNNING) {
+        ssize_t r = recv(c->fd, c->in + c->in_len, (size_t)(IN_CAP - c->in_len), MSG_DONTWAIT);
+        if (r < 0 && errno == EINTR) continue;
+        if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+        if (r <= 0) {
+            w->st.closed++;
+            conn_close(w, c);
+            return;
+        }
+
+        w->st.bytes += r;
+        c->in_len += (int)r;
+
+        if ((binary ? parse_binary(w, c) : parse_text(w, c)) < 0) {
+            w->st.errors++;
+            conn_close(w, c);
+            return;
+        }
+
+        /* koniec hry: nova hra na novom spojeni */
+        if (c->game_over) {
+            w->st.games++;
+            conn_close(w, c);
+            return;
+        }
+    }
+}
+
+static void send_moves(Worker* w, long long now) {
+    static const char* moves[] = {
+        CMD_MOVE " w\n", CMD_MOVE " a\n", CMD_MOVE " s\n", CMD_MOVE " d\n"
+    };
+    long long period = (long long)(1e9 / move_rate);
+
+    for (int i = 0; i < w->count; i++) {
+        Conn* c = &w->conns[i];
+        if (c->state != C_RUNNING || now < c->next_move) continue;
+
+        if (conn_send(c, moves[rand_r(&w->seed) % 4])) w->st.moves++;
+        c->next_move += period;
+        if (c->next_move < now) c->next_move = now + period;
+    }
+}
+
+static void* worker_run(void* arg) {
+    Worker* w = (Worker*)arg;
+    struct epoll_event evs[MAX_EVENTS];
+
+    for (int i = 0; i < w->count; i++) conn_open(w, &w->conns[i]);
+
+    while (1) {
+        long long now = now_ns();
+        if (now >= end_ns) break;
+
+        /* MOVE kontrolujeme kazdych 5 ms, koniec behu najneskor po nom */
+        int n = epoll_wait(w->epfd, evs, MAX_EVENTS, 5);
+        if (n < 0 && errno != EINTR) { perror("epoll_wait"); break; }
+
+        for (int i = 0; i < n; i++) {
+            Conn* c = (Conn*)evs[i].data.ptr;
+            if (c->state == C_CONNECTING) {
+                if (evs[i].events & (EPOLLOUT | EPOLLERR | EPOLLHUP)) conn_connected(w, c);
+            }
+            else if (c->state == C_RUNNING) {
+                conn_read(w, c);
+            }
+        }
+
+        now = now_ns();
+        if (move_rate > 0) send_moves(w, now);
+
+        /* zavrete spojenia (koniec hry, chyba) nahradime novymi */
+        for (int i = 0; i < w->count; i++) {
+            if (w->conns[i].state == C_IDLE) conn_open(w, &w->conns[i]);
+        }
+    }
+
+    for (int i = 0; i < w->count; i++) conn_close(w, &w->conns[i]);
+    return NULL;
+}
+
+static double jit_percentile(const long* jit, long total, double p) {
+    long want = (long)(total * p), seen = 0;
+    for (int b = 0; b < JIT_BUCKETS; b++) {
+        seen += jit[b];
+        if (seen > want) return (b + 0.5) * JIT_BUCKET_NS / 1e6;
+    }
+    return JIT_BUCKETS * JIT_BUCKET_NS / 1e6;
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr,
+        "Pouzitie: %s [-n CONNS] [-w THREADS] [-d SEC] [-r MOVES] [-t TICK_MS]\n"
+        "          [-H HOST] [-p PORT] [-f FULL|DELTA|BINARY] [-S \"START parametre\"] [-W]\n"
+        "  -n CONNS   pocet sucasnych hracov (default 100)\n"
+        "  -w THREADS pocet epoll vlakien (default 2)\n"
+        "  -d SEC     dlzka behu (default 10)\n"
+        "  -r MOVES   MOVE za sekundu na hraca (default 5, 0 = ziadne)\n"
+        "  -t TICK_MS ocakavana perioda ticku servera pre jitter (default 150)\n"
+        "  -S PARAMS  parametre START (default \"20 40 WRAP NOOBS STANDARD\")\n"
+        "  -W         divaci: WATCH namiesto START, bez MOVE (treba hracov v arene)\n"
+        "Server spustit ako: server -m\n",
+        prog);
+}
+
+int main(int argc, char** argv) {
+    int conns = 100, threads = 2, duration = 10, port = SERVER_PORT;
+    const char* host = "127.0.0.1";
+    const char* params = "20 40 WRAP NOOBS STANDARD";
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:w:d:r:t:H:p:f:S:Wh")) != -1) {
+        switch (opt) {
+        case 'n': conns = atoi(optarg); break;
+        case 'w': threads = atoi(optarg); break;
+        case 'd': duration = atoi(optarg); break;
+        case 'r': move_rate = atof(optarg); break;
+        case 't': tick_ns = atoll(optarg) * 1000000LL; break;
+        case 'H': host = optarg; break;
+        case 'p': port = atoi(optarg); break;
+        case 'f':
+            if (strcmp(optarg, FRAMES_FULL) == 0) frame_format = FRAMES_FULL;
+            else if (strcmp(optarg, FRAMES_DELTA) == 0) frame_format = FRAMES_DELTA;
+            else if (strcmp(optarg, FRAMES_BINARY) == 0) frame_format = FRAMES_BINARY;
+            else { usage(argv[0]); return 1; }
+            break;
+        case 'S': params = optarg; break;
+        case 'W': watch = 1; break;
+        default: usage(argv[0]); return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (conns < 1) conns = 1;
+    if (threads < 1) threads = 1;
+    if (threads > conns) threads = conns;
+
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_port = htons((uint16_t)port);
+    if (inet_pton(AF_INET, host, &server_addr.sin_addr) != 1) {
+        fprintf(stderr, "Neplatna adresa: %s\n", host);
+        return 1;
+    }
+
+    binary = strcmp(frame_format, FRAMES_BINARY) == 0;
+    if (watch) {
+        snprintf(start_cmd, sizeof(start_cmd), "%s %s\n", CMD_WATCH, frame_format);
+        move_rate = 0;
+    }
+    else {
+        snprintf(start_cmd, sizeof(start_cmd), "%s %s %s\n", CMD_START, params, frame_format);
+    }
+
+    Worker* ws = calloc((size_t)threads, sizeof(*ws));
+    Conn* all = calloc((size_t)conns, sizeof(*all));
+    if (!ws || !all) { perror("calloc"); return 1; }
+
+    printf("loadgen: %d %s, %d vlakien, %d s, %.1f MOVE/s, %s",
+           conns, watch ? "divakov" : "hracov", threads, duration, move_rate, start_cmd);
+
+    long long t0 = now_ns();
+    end_ns = t0 + (long long)duration * 1000000000LL;
+
+    /* spojenia rozdelime do suvislych blokov po vlaknach */
+    int per = conns / threads, extra = conns % threads, off = 0;
+    for (int i = 0; i < threads; i++) {
+        ws[i].id = i;
+        ws[i].seed = (unsigned)(t0 + i);
+        ws[i].conns = all + off;
+        ws[i].count = per + (i < extra ? 1 : 0);
+        off += ws[i].count;
+        ws[i].epfd = epoll_create1(0);
+        if (ws[i].epfd < 0) { perror("epoll_create1"); return 1; }
+        pthread_create(&ws[i].th, NULL, worker_run, &ws[i]);
+    }
+
+    Stats st;
+    memset(&st, 0, sizeof(st));
+    for (int i = 0; i < threads; i++) {
+        pthread_join(ws[i].th, NULL);
+        close(ws[i].epfd);
+
+        Stats* s = &ws[i].st;
+        st.connects += s->connects;
+        st.connect_fail += s->connect_fail;
+        st.connect_ns_sum += s->connect_ns_sum;
+        if (s->connect_ns_max > st.connect_ns_max) st.connect_ns_max = s->connect_ns_max;
+        st.games += s->games;
+        st.frames += s->frames;
+        st.bytes += s->bytes;
+        st.moves += s->moves;
+        st.errors += s->errors;
+        st.closed += s->closed;
+        for (int b = 0; b < JIT_BUCKETS; b++) st.jit[b] += s->jit[b];
+        if (s->jit_max > st.jit_max) st.jit_max = s->jit_max;
+    }
+    double sec = (now_ns() - t0) / 1e9;
+
+    long jit_total = 0;
+    for (int b = 0; b < JIT_BUCKETS; b++) jit_total += st.jit[b];
+
+    printf("spojenia:  %ld ok, %ld zlyhalo, nadviazanie avg %.3f ms max %.3f ms\n",
+           st.connects, st.connect_fail,
+           st.connects ? st.connect_ns_sum / 1e6 / st.connects : 0.0, st.connect_ns_max / 1e6);
+    printf("ramce:     %ld (%.0f/s), %.2f MB/s, hier dohranych %ld\n",
+           st.frames, st.frames / sec, st.bytes / 1048576.0 / sec, st.games);
+    printf("MOVE:      %ld (%.0f/s)\n", st.moves, st.moves / sec);
+    printf("jitter:    p50 %.2f ms p99 %.2f ms max %.2f ms (voci %.0f ms ticku)\n",
+           jit_percentile(st.jit, jit_total, 0.50), jit_percentile(st.jit, jit_total, 0.99),
+           st.jit_max / 1e6, tick_ns / 1e6);
+    printf("chyby:     %ld chybnych ramcov, %ld zavretych serverom pred koncom hry\n",
+           st.errors, st.closed);
+
+    free(all);
+    free(ws);
+    return st.errors ? 2 : 0;
+}
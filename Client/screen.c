@@ -0,0 +1,181 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "screen.h"
+
+// zmeny blizsie ako toto sa posielaju spolu (presun kurzora ma ~7 bajtov)
+#define RUN_GAP 6
+
+void scr_invalidate(Screen* s) {
+    s->valid = 0;
+}
+
+void scr_begin(Screen* s) {
+    s->back.nlines = 0;
+}
+
+void scr_text(Screen* s, const char* text, int len) {
+    ScreenBuf* b = &s->back;
+    if (b->nlines >= SCR_ROWS) return;
+    if (len > SCR_LINE) len = SCR_LINE;
+
+    memcpy(b->text[b->nlines], text, (size_t)len);
+    b->len[b->nlines] = len;
+    b->nlines++;
+}
+
+void scr_line(Screen* s, const char* fmt, ...) {
+    char line[SCR_LINE + 1];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(line, sizeof(line), fmt, ap);
+    va_end(ap);
+
+    if (n < 0) n = 0;
+    if (n > SCR_LINE) n = SCR_LINE;
+    scr_text(s, line, n);
+}
+
+static int is_ascii(const char* p, int len) {
+    for (int i = 0; i < len; i++) {
+        if ((unsigned char)p[i] >= 0x80) return 0;
+    }
+    return 1;
+}
+
+/* Vystup a pozicia kurzora (riadok/stlpec od 0, -1 = nevieme) */
+typedef struct {
+    char* out;
+    int n;
+    int row, col;
+} Emit;
+
+/* Viditelne znaky, kurzor sa posunie za ne */
+static void put(Emit* e, const char* p, int len) {
+    memcpy(e->out + e->n, p, (size_t)len);
+    e->n += len;
+    e->col += len;
+}
+
+/* Riadiaca sekvencia, kurzor ostava */
+static void seq(Emit* e, const char* p) {
+    int len = (int)strlen(p);
+    memcpy(e->out + e->n, p, (size_t)len);
+    e->n += len;
+}
+
+static void move_to(Emit* e, int row, int col) {
+    if (e->row == row && e->col == col) return;
+
+    if (e->row >= 0 && row == e->row + 1 && col == 0) seq(e, "\r\n");
+    else e->n += sprintf(e->out + e->n, "\033[%d;%dH", row + 1, col + 1);
+    e->row = row;
+    e->col = col;
+}
+
+/* Cely riadok od zaciatku, zvysok stareho zmazat */
+static void line_full(Emit* e, int y, const char* p, int len, int clear) {
+    move_to(e, y, 0);
+    put(e, p, len);
+    if (clear) seq(e, "\033[K");
+    /* stlpec po UTF-8 nepozname */
+    if (!is_ascii(p, len)) e->row = -1;
+}
+
+/* ASCII riadok: len useky zmenenych bajtov */
+static void line_diff(Emit* e, int y, const char* old, int olen, const char* p, int len) {
+    int m = olen < len ? olen : len;
+
+    for (int i = 0; i < m; ) {
+        if (old[i] == p[i]) { i++; continue; }
+
+        /* usek zmien, blizke useky spojime */
+        int end = i + 1, last = i;
+        while (end < m && end - last <= RUN_GAP) {
+            if (old[end] != p[end]) last = end;
+            end++;
+        }
+        move_to(e, y, i);
+        put(e, p + i, last - i + 1);
+        i = last + 1;
+    }
+
+    if (len > olen) {
+        move_to(e, y, olen);
+        put(e, p + olen, len - olen);
+    }
+    else if (len < olen) {
+        move_to(e, y, len);
+        seq(e, "\033[K");
+    }
+}
+
+int scr_diff(Screen* s, char* out) {
+    ScreenBuf* f = &s->front;
+    ScreenBuf* b = &s->back;
+    Emit e = { out, 0, -1, -1 };
+    int redraw = !s->valid;
+
+    if (redraw) {
+        /* prvy ramec alebo po cudzom vystupe: vsetko odznova */
+        seq(&e, "\033[H\033[J");
+        e.row = 0;
+        e.col = 0;
+        f->nlines = 0;
+    }
+
+    for (int y = 0; y < b->nlines; y++) {
+        const char* p = b->text[y];
+        int len = b->len[y];
+
+        if (y >= f->nlines) {
+            line_full(&e, y, p, len, !redraw);
+        }
+        else if (f->len[y] == len && memcmp(f->text[y], p, (size_t)len) == 0) {
+            continue;
+        }
+        else if (is_ascii(f->text[y], f->len[y]) && is_ascii(p, len)) {
+            line_diff(&e, y, f->text[y], f->len[y], p, len);
+        }
+        else {
+            line_full(&e, y, p, len, 1);
+        }
+
+        memcpy(f->text[y], p, (size_t)len);
+        f->len[y] = len;
+    }
+
+    /* ramec je kratsi ako predchadzajuci */
+    if (f->nlines > b->nlines) {
+        move_to(&e, b->nlines, 0);
+        seq(&e, "\033[J");
+    }
+    f->nlines = b->nlines;
+
+    /* kurzor pod ramec, aby dalsi vystup (GAME OVER) nepisal do mapy */
+    if (e.n > 0) move_to(&e, b->nlines, 0);
+
+    s->valid = 1;
+    return e.n;
+}
+
+int scr_flush(Screen* s, int fd) {
+    static char out[SCR_OUT_CAP];
+    int n = scr_diff(s, out);
+
+    int off = 0;
+    while (off < n) {
+        ssize_t w = write(fd, out + off, (size_t)(n - off));
+        if (w <= 0) break;
+        off += (int)w;
+    }
+
+    s->frames++;
+    s->bytes += n;
+    s->last_bytes = n;
+    return n;
+}
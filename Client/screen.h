@@ -0,0 +1,54 @@
+#pragma once
+
+/*
+ * Dvojity buffer obrazovky terminalu.
+ *
+ * Ramec sa sklada do back (riadok po riadku), scr_diff ho porovna s tym,
+ * co je na terminali (front), a vyrobi len presuny kurzora a zmenene znaky.
+ * scr_flush to posle jednym write - bez mazania obrazovky, bez blikania.
+ *
+ * Riadky s UTF-8 (ramceky hlavicky) sa pri zmene prepisu cele,
+ * ASCII riadky (mapa) po useckoch zmenenych bajtov.
+ */
+#define SCR_ROWS 80
+#define SCR_LINE 512        // bajty riadku (znak ramceka ma 3 bajty)
+#define SCR_OUT_CAP (SCR_ROWS * (SCR_LINE + 32) + 64)
+
+typedef struct {
+    char text[SCR_ROWS][SCR_LINE];
+    int len[SCR_ROWS];
+    int nlines;
+} ScreenBuf;
+
+typedef struct {
+    ScreenBuf front;        // co je na terminali
+    ScreenBuf back;         // skladany ramec
+    int valid;              // front zodpoveda terminalu (inak sa kresli cely ramec)
+
+    /* statistika */
+    long frames;
+    long long bytes;        // spolu zapisane na tty
+    int last_bytes;         // posledny ramec
+} Screen;
+
+// Na terminal pisal niekto iny (menu, GAME OVER) - dalsi ramec sa nakresli cely
+void scr_invalidate(Screen* s);
+
+// Zacne novy ramec (back je prazdny)
+void scr_begin(Screen* s);
+
+// Prida riadok do ramca (printf format, bez '\n')
+void scr_line(Screen* s, const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+
+// Prida riadok z bajtov (napr. riadok mapy)
+void scr_text(Screen* s, const char* text, int len);
+
+/*
+  Porovna back s front a zapise do out escape sekvencie, ktore terminal
+  prevedu z front na back. front potom = back. Vrati pocet bajtov.
+  out musi mat aspon SCR_OUT_CAP bajtov.
+*/
+int scr_diff(Screen* s, char* out);
+
+// scr_diff + jeden write na fd, zapocita bajty do statistiky. Vrati pocet bajtov
+int scr_flush(Screen* s, int fd);
@@ -1,4 +1,5 @@
 #pragma once
+#include <stdint.h>
 
 //SERVER
 // Port, na ktorom server pocuva
@@ -7,10 +8,25 @@
 
 
 //PRIKAZY OD KLIENTA
-// start hry (napr. "START WALLS STANDARD" alebo "START WRAP TIMED 60")
+// start hry: START <rows> <cols> <WALLS/WRAP> <OBS/NOOBS> <STANDARD/TIMED> [time] [format]
+// (napr. "START 20 40 WALLS NOOBS STANDARD" alebo "START 30 60 WRAP OBS TIMED 60 DELTA")
 #define CMD_START "START"
 
-// pohyb hraca
+// volitelny posledny token START: format ramcov
+#define FRAMES_FULL "FULL"      // kazdy tick cela mapa (default)
+#define FRAMES_DELTA "DELTA"    // keyframe + len zmenene policka
+#define FRAMES_BINARY "BINARY"  // binarne ramce s pevnou hlavickou (nizsie)
+
+// token START pred formatom: pridat sa do spolocnej areny (server -m)
+// (napr. "START 30 60 WRAP NOOBS STANDARD ARENA BINARY")
+#define START_ARENA "ARENA"
+
+// divak: WATCH [FULL/DELTA/BINARY] - sleduje arenu servera (server -m),
+// nema vlastneho hada, vidi vsetkych hadov a vsetko ovocie
+#define CMD_WATCH "WATCH"
+
+// pohyb hraca: MOVE <w/a/s/d> [seq]
+// seq (od 1) = poradove cislo pre meranie latencie, server ho potvrdi cez ACK
 #define CMD_MOVE "MOVE"
 
 // korektne ukoncenie klienta
@@ -28,14 +44,120 @@
 // obycajna textova sprava
 #define CMD_MSG "MSG"
 
+// START odmietnuty (napr. mapa nad limit servera): ERROR <sprava>\n, potom server
+// spojenie zavrie. Posiela sa ako text aj pri formate BINARY (ramce este nezacali)
+#define CMD_ERROR "ERROR"
+
 // herna mapa (ASCII vypis)
 #define CMD_MAP "MAP"
 
-// skore hraca
+// skore hraca (v plnom ramci je cislo zarovnane doprava medzerami)
 #define CMD_SCORE "SCORE"
 
-// cas hry v sekundach
+// cas hry v sekundach (v plnom ramci zarovnany doprava medzerami)
 #define CMD_TIME "TIME"
 
 // koniec hry (kolizia)
 #define CMD_GAME_OVER "GAME_OVER"
+
+// za GAME_OVER: had zaplnil celu mapu (vyhra)
+#define CMD_WIN "WIN"
+
+// zmenene policka od posledneho ramca (rezim DELTA):
+//   DELTA <n>\n [SCORE ..\n] [TIME ..\n] <znak> <x> <y>\n (n krat) ENDDELTA\n
+// plny ramec (keyframe) ma rovnaky tvar ako v rezime FULL (MAP ... ENDMAP)
+#define CMD_DELTA "DELTA"
+#define CMD_ENDDELTA "ENDDELTA"
+
+// pred ramcom, v ktorom je prvykrat vidiet MOVE so seq (len ak klient seq posiela):
+//   ACK <seq> <tick> <cakanie_us>\n
+// seq = posledny aplikovany MOVE, tick = cislo ticku session, ktory ho aplikoval,
+// cakanie_us = od prijatia prikazu serverom po jeho aplikovanie
+#define CMD_ACK "ACK"
+
+//________________________________________________________
+
+
+//BINARNE RAMCE (format BINARY)
+/*
+  Kazdy ramec = pevna hlavicka FRAME_HDR_SIZE bajtov + payload dlzky len.
+  Vsetky cisla su big-endian. Klient precita hlavicku, pocka na len bajtov
+  payloadu a spracuje ramec naraz, bez hladania v texte.
+
+  Payload podla typu:
+    FRAME_KEY        rows*cols bajtov mapy (po riadkoch, bez '\n')
+    FRAME_DELTA      n * FRAME_CELL_SIZE: x (u16), y (u16), znak (u8)
+    FRAME_GAME_OVER  prazdny (dovod je vo flags)
+    FRAME_ACK        seq (u32), tick (u32), cakanie_us (u32) - ako textovy ACK
+*/
+#define FRAME_MAGIC 0x534E      // "SN"
+#define FRAME_HDR_SIZE 20
+#define FRAME_CELL_SIZE 5
+
+typedef enum {
+    FRAME_KEY = 1,
+    FRAME_DELTA = 2,
+    FRAME_GAME_OVER = 3,
+    FRAME_ACK = 4
+} FrameType;
+
+#define FRAME_ACK_SIZE 12
+
+// flags
+#define FRAME_F_PAUSED    0x01  // hra je pozastavena
+#define FRAME_F_TIMED     0x02  // casovy rezim, time = zostavajuci cas
+#define FRAME_F_TIMEOUT   0x04  // GAME_OVER: vyprsal cas
+#define FRAME_F_WIN       0x08  // GAME_OVER: plna mapa (vyhra)
+
+typedef struct {
+    uint16_t magic;
+    uint8_t type;
+    uint8_t flags;
+    uint32_t len;       // dlzka payloadu v bajtoch
+    int32_t score;
+    int32_t time_sec;   // uplynuly cas, v casovom rezime zostavajuci
+    uint16_t rows;
+    uint16_t cols;
+} FrameHeader;
+
+static inline void put_u16(unsigned char* p, uint16_t v) {
+    p[0] = (unsigned char)(v >> 8);
+    p[1] = (unsigned char)v;
+}
+
+static inline void put_u32(unsigned char* p, uint32_t v) {
+    p[0] = (unsigned char)(v >> 24);
+    p[1] = (unsigned char)(v >> 16);
+    p[2] = (unsigned char)(v >> 8);
+    p[3] = (unsigned char)v;
+}
+
+static inline uint16_t get_u16(const unsigned char* p) {
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static inline uint32_t get_u32(const unsigned char* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static inline void frame_hdr_pack(const FrameHeader* h, unsigned char* out) {
+    put_u16(out + 0, h->magic);
+    out[2] = h->type;
+    out[3] = h->flags;
+    put_u32(out + 4, h->len);
+    put_u32(out + 8, (uint32_t)h->score);
+    put_u32(out + 12, (uint32_t)h->time_sec);
+    put_u16(out + 16, h->rows);
+    put_u16(out + 18, h->cols);
+}
+
+static inline void frame_hdr_unpack(const unsigned char* in, FrameHeader* h) {
+    h->magic = get_u16(in + 0);
+    h->type = in[2];
+    h->flags = in[3];
+    h->len = get_u32(in + 4);
+    h->score = (int32_t)get_u32(in + 8);
+    h->time_sec = (int32_t)get_u32(in + 12);
+    h->rows = get_u16(in + 16);
+    h->cols = get_u16(in + 18);
+}
@@ -0,0 +1,105 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/socket.h>
+
+#include "broadcast.h"
+
+SharedFrame* shared_frame_new(const char* data, int len, int key) {
+    SharedFrame* f = malloc(sizeof(*f) + (size_t)len);
+    if (!f) return NULL;
+
+    f->refs = 1;
+    f->len = len;
+    f->key = key;
+    memcpy(f->data, data, (size_t)len);
+    return f;
+}
+
+void shared_frame_unref(SharedFrame* f) {
+    if (f && --f->refs == 0) free(f);
+}
+
+void broadcast_init(Broadcast* b, FrameFormat format) {
+    memset(b, 0, sizeof(*b));
+    frame_state_init(&b->fs, format);
+    b->fs.player = VIEWER_SPECTATOR;
+}
+
+/* FULL je vzdy cela mapa, DELTA/BINARY po keyframe vynuluju since_key */
+static int is_key(const FrameState* fs) {
+    return fs->format == FMT_FULL || fs->since_key == 0;
+}
+
+SharedFrame* broadcast_build(Broadcast* b, GameState* g, char* scratch, int cap,
+                             SharedFrame** key) {
+    int resync = b->resync;
+    b->resync = 0;
+    *key = NULL;
+
+    int n = frame_build(&b->fs, g, scratch, cap);
+    if (n <= 0) return NULL;
+
+    SharedFrame* f = shared_frame_new(scratch, n, is_key(&b->fs));
+    if (!f || f->key || !resync) return f;
+
+    /*
+     * Keyframe z kopie stavu streamu (aj jeho vyrezu) po tomto ticku: ukazuje
+     * to iste okno ako stream, takze dalsia delta plati aj pre divaka,
+     * ktory ho dostane. Vlastny vyrez by sa na velkej mape posuval inak.
+     */
+    b->key = b->fs;
+    b->key.have_key = 0;
+    n = frame_build(&b->key, g, scratch, cap);
+    if (n > 0) *key = shared_frame_new(scratch, n, 1);
+    return f;
+}
+
+int watcher_flush(Watcher* w, int fd) {
+    while (w->pending) {
+        SharedFrame* f = w->pending;
+        ssize_t r = send(fd, f->data + w->sent, (size_t)(f->len - w->sent),
+                         MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (r < 0) {
+            if (errno == EINTR) continue;
+            return errno == EAGAIN || errno == EWOULDBLOCK ? 0 : -1;
+        }
+
+        w->sent += (int)r;
+        if (w->sent == f->len) {
+            shared_frame_unref(f);
+            w->pending = NULL;
+            w->sent = 0;
+            w->frames++;
+        }
+    }
+    return 1;
+}
+
+int watcher_offer(Watcher* w, int fd, SharedFrame* f) {
+    int r = watcher_flush(w, fd);
+    if (r < 0) return -1;
+
+    /* predchadzajuci ramec este ide: novy zahodime, dalej az od keyframe */
+    if (r == 0) {
+        w->drops++;
+        w->synced = 0;
+        return 0;
+    }
+
+    if (!f->key && !w->synced) return 0;
+    w->synced = 1;
+
+    f->refs++;
+    w->pending = f;
+    w->sent = 0;
+    return watcher_flush(w, fd) < 0 ? -1 : 0;
+}
+
+void watcher_release(Watcher* w) {
+    shared_frame_unref(w->pending);
+    w->pending = NULL;
+    w->sent = 0;
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include "game.h"
+#include "frame.h"
+
+/*
+ * Vysielanie jednej hry vela divakom (WATCH).
+ *
+ * Ramec sa zakoduje raz za tick pre kazdy format (Broadcast) do zdielaneho
+ * buffera s pocitadlom referencii (SharedFrame). Kazdy divak (Watcher) si
+ * drzi referenciu na ramec, ktory prave odosiela, kym ho cely neodosle.
+ * Posiela sa len neblokujuco - pomaly divak nikdy nezdrzi loop, jeho
+ * ramce sa zahodia a po dobehnuti dostane keyframe. Keyframe pre takych
+ * divakov sa sklada zvlast (raz za tick pre vsetkych), ostatni dostavaju
+ * dalej delty - stream sa kvoli jednemu divakovi nemeni.
+ *
+ * Pocitadlo referencii nie je atomicke: ramce aj divaci patria jednemu
+ * event loopu (vlaknu).
+ */
+typedef struct {
+    int refs;
+    int len;
+    int key;            // keyframe (divak od neho moze zacat citat)
+    char data[];
+} SharedFrame;
+
+/* Novy ramec s kopiou data a jednou referenciou (volajuceho). NULL pri chybe */
+SharedFrame* shared_frame_new(const char* data, int len, int key);
+
+void shared_frame_unref(SharedFrame* f);
+
+/* Stream pre jeden format: co divaci tohto formatu naposledy videli */
+typedef struct {
+    FrameState fs;
+    FrameState key;     // keyframe pre resync (kopia fs pred skladanim)
+    int watchers;       // pocet divakov v tomto ticku
+    int resync;         // niektory divak potrebuje keyframe
+} Broadcast;
+
+void broadcast_init(Broadcast* b, FrameFormat format);
+
+/*
+  Zakoduje ramec hry z pohladu divaka (vola sa pod g->mtx).
+  Ak niektory divak potrebuje keyframe (resync) a ramec streamu nim nie je,
+  *key dostane samostatny keyframe toho isteho ticku, inak NULL. Delty
+  streamu nadvazuju aj na neho.
+  scratch je pracovny buffer. Vrati ramec s jednou referenciou alebo NULL.
+*/
+SharedFrame* broadcast_build(Broadcast* b, GameState* g, char* scratch, int cap,
+                             SharedFrame** key);
+
+typedef struct {
+    SharedFrame* pending;   // ramec, ktory sa prave odosiela (alebo NULL)
+    int sent;               // kolko bajtov z pending uz odislo
+    int synced;             // divak ma keyframe, moze dostavat delty
+    long frames;            // cele odoslane ramce
+    long drops;             // zahodene ramce (socket plny)
+} Watcher;
+
+/*
+  Posle zvysok pending ramca bez blokovania.
+  Vrati 1 (ziadny pending), 0 (socket plny, zvysok neskor) alebo -1 (chyba spojenia).
+*/
+int watcher_flush(Watcher* w, int fd);
+
+/*
+  Ponukne divakovi novy ramec. Ak este odosiela predchadzajuci, novy zahodi
+  a divak potrebuje keyframe. Delty pred prvym keyframe preskoci.
+  Vrati -1 pri chybe spojenia, inak 0.
+*/
+int watcher_offer(Watcher* w, int fd, SharedFrame* f);
+
+/* Uvolni referenciu na pending ramec (odpojenie divaka) */
+void watcher_release(Watcher* w);
@@ -0,0 +1,287 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "../Common/protocol.h"
+#include "frame.h"
+
+void frame_state_init(FrameState* fs, FrameFormat format) {
+    memset(fs, 0, sizeof(*fs));
+    fs->format = format;
+}
+
+/* Cas do hlavicky v s: uplynuly, v casovom rezime zostavajuci (zaokruhleny nahor) */
+static int frame_time(const GameState* g) {
+    long long elapsed = game_elapsed_ms(g);
+
+    if (g->game_mode == MODE_TIMED) {
+        long long remaining = (long long)g->time_limit_sec * 1000 - elapsed;
+        return remaining <= 0 ? 0 : (int)((remaining + 999) / 1000);
+    }
+    return (int)(elapsed / 1000);
+}
+
+/* Skore hraca, divak vidi najlepsie skore v hre */
+static int frame_score(const FrameState* fs, const GameState* g) {
+    if (fs->player != VIEWER_SPECTATOR) return g->players[fs->player].score;
+
+    int best = 0;
+    for (int p = 0; p < g->max_players; p++) {
+        if (g->players[p].active && g->players[p].score > best) best = g->players[p].score;
+    }
+    return best;
+}
+
+/* Riadok TIME (uplynuly alebo zostavajuci cas) */
+static int time_line(const FrameSnap* snap, char* buf, int cap) {
+    if (snap->timed) return snprintf(buf, cap, "%s %ds LEFT\n", CMD_TIME, snap->time_sec);
+    return snprintf(buf, cap, "%s %ds\n", CMD_TIME, snap->time_sec);
+}
+
+/* Cisla do hlavicky ramca (bez mapy) */
+static void snap_state(FrameState* fs, const GameState* g) {
+    FrameSnap* snap = &fs->snap;
+    snap->score = frame_score(fs, g);
+    snap->time_sec = frame_time(g);
+    snap->paused = g->paused;
+    snap->timed = g->game_mode == MODE_TIMED;
+}
+
+/* Zapamata si vyrez z keyframe (fs->cur musi byt poskladany) */
+static void remember_key(FrameState* fs) {
+    for (int y = 0; y < fs->view.rows; y++)
+        memcpy(fs->sent[y], fs->cur[y], (size_t)fs->view.cols);
+    fs->have_key = 1;
+    fs->since_key = 0;
+    fs->paused = fs->snap.paused;
+    fs->rows = fs->view.rows;
+    fs->cols = fs->view.cols;
+    fs->score = fs->snap.score;
+}
+
+/* Treba poslat plny ramec namiesto delty? */
+static int need_key(const FrameState* fs) {
+    /* prvy ramec, periodicky resync, zmena pauzy (banner), iny rozmer vyrezu */
+    return !fs->have_key || fs->since_key >= KEYFRAME_INTERVAL ||
+        fs->paused != fs->snap.paused || fs->rows != fs->view.rows || fs->cols != fs->view.cols;
+}
+
+/*
+  Indexy policok vyrezu, ktore sa zmenili oproti tomu, co klient vidi
+  (aj po posune vyrezu - ked sa zmeni privela, posle sa keyframe)
+*/
+static int diff_cells(const FrameState* fs, int* changed) {
+    int count = 0;
+    for (int y = 0; y < fs->view.rows; y++) {
+        for (int x = 0; x < fs->view.cols; x++) {
+            if (fs->cur[y][x] != fs->sent[y][x]) changed[count++] = y * VIEW_COLS + x;
+        }
+    }
+    return count;
+}
+
+/* Plny textovy ramec: hlavicka zo sablony hry + riadky vyrezu a ENDMAP */
+static int build_full(FrameState* fs, char* out, int out_cap) {
+    const MapView* v = &fs->view;
+    int n = fs->snap.head_len;
+    int end = (int)strlen("ENDMAP\n");
+    if (n == 0 || n + v->rows * (v->cols + 1) + end > out_cap) return 0;
+
+    memcpy(out, fs->snap.head, (size_t)n);
+    for (int y = 0; y < v->rows; y++) {
+        memcpy(out + n, fs->cur[y], (size_t)v->cols);
+        n += v->cols;
+        out[n++] = '\n';
+    }
+    memcpy(out + n, "ENDMAP\n", (size_t)end);
+    n += end;
+
+    /* zapamatame si, co klient vidi */
+    if (fs->format == FMT_DELTA) {
+        remember_key(fs);
+        time_line(&fs->snap, fs->time_line, sizeof(fs->time_line));
+    }
+    return n;
+}
+
+/* Textova delta: DELTA <n>, zmeneny SCORE/TIME, zmenene policka */
+static int build_text_delta(FrameState* fs, char* out, int out_cap) {
+    if (need_key(fs)) return build_full(fs, out, out_cap);
+
+    static const int CELL_BYTES = 12;   // "c xx yy\n" s rezervou
+    int changed[VIEW_ROWS * VIEW_COLS];
+    int count = diff_cells(fs, changed);
+
+    /* ked sa zmenilo privela, keyframe je mensi */
+    if (count * CELL_BYTES > out_cap / 2 || count > fs->view.rows * fs->view.cols / 4) {
+        return build_full(fs, out, out_cap);
+    }
+
+    int n = snprintf(out, out_cap, "%s %d\n", CMD_DELTA, count);
+
+    int score = fs->snap.score;
+    if (score != fs->score) {
+        n += snprintf(out + n, out_cap - n, "%s %d\n", CMD_SCORE, score);
+        fs->score = score;
+    }
+
+    char tl[32];
+    time_line(&fs->snap, tl, sizeof(tl));
+    if (strcmp(tl, fs->time_line) != 0) {
+        n += snprintf(out + n, out_cap - n, "%s", tl);
+        strcpy(fs->time_line, tl);
+    }
+
+    for (int i = 0; i < count; i++) {
+        int y = changed[i] / VIEW_COLS;
+        int x = changed[i] % VIEW_COLS;
+        char c = fs->cur[y][x];
+        n += snprintf(out + n, out_cap - n, "%c %d %d\n", c, x, y);
+        fs->sent[y][x] = c;
+    }
+
+    n += snprintf(out + n, out_cap - n, "%s\n", CMD_ENDDELTA);
+    fs->since_key++;
+    return n;
+}
+
+/* Hlavicka binarneho ramca zo stavu hry (fs->snap) */
+static void bin_header(const FrameState* fs, FrameType type, uint32_t len, unsigned char* out) {
+    FrameHeader h = {
+        .magic = FRAME_MAGIC,
+        .type = (uint8_t)type,
+        .flags = (uint8_t)((fs->snap.paused ? FRAME_F_PAUSED : 0) |
+                           (fs->snap.timed ? FRAME_F_TIMED : 0)),
+        .len = len,
+        .score = (uint32_t)fs->snap.score,
+        .time_sec = (uint32_t)fs->snap.time_sec,
+        .rows = (uint16_t)fs->view.rows,
+        .cols = (uint16_t)fs->view.cols
+    };
+    frame_hdr_pack(&h, out);
+}
+
+/* Binarny keyframe: hlavicka + rows*cols bajtov vyrezu */
+static int build_bin_key(FrameState* fs, char* out, int out_cap) {
+    int len = fs->view.rows * fs->view.cols;
+    if (FRAME_HDR_SIZE + len > out_cap) return 0;
+
+    bin_header(fs, FRAME_KEY, (uint32_t)len, (unsigned char*)out);
+
+    char* p = out + FRAME_HDR_SIZE;
+    for (int y = 0; y < fs->view.rows; y++) {
+        memcpy(p, fs->cur[y], (size_t)fs->view.cols);
+        p += fs->view.cols;
+    }
+
+    remember_key(fs);
+    return FRAME_HDR_SIZE + len;
+}
+
+/* Binarna delta: hlavicka + zmenene policka (x, y, znak) */
+static int build_bin_delta(FrameState* fs, char* out, int out_cap) {
+    if (need_key(fs)) return build_bin_key(fs, out, out_cap);
+
+    int changed[VIEW_ROWS * VIEW_COLS];
+    int count = diff_cells(fs, changed);
+    int len = count * FRAME_CELL_SIZE;
+
+    if (len >= fs->view.rows * fs->view.cols || FRAME_HDR_SIZE + len > out_cap) {
+        return build_bin_key(fs, out, out_cap);
+    }
+
+    bin_header(fs, FRAME_DELTA, (uint32_t)len, (unsigned char*)out);
+
+    unsigned char* p = (unsigned char*)out + FRAME_HDR_SIZE;
+    for (int i = 0; i < count; i++) {
+        int y = changed[i] / VIEW_COLS;
+        int x = changed[i] % VIEW_COLS;
+        put_u16(p, (uint16_t)x);
+        put_u16(p + 2, (uint16_t)y);
+        p[4] = (unsigned char)fs->cur[y][x];
+        p += FRAME_CELL_SIZE;
+        fs->sent[y][x] = fs->cur[y][x];
+    }
+
+    fs->score = fs->snap.score;
+    fs->since_key++;
+    return FRAME_HDR_SIZE + len;
+}
+
+void frame_capture(FrameState* fs, const GameState* g) {
+    game_view(g, fs->player, &fs->view);
+    game_compose_view(g, fs->player, &fs->view, &fs->cur[0][0], VIEW_COLS);
+    snap_state(fs, g);
+
+    /* hlavicku plneho textoveho ramca treba len textovym formatom */
+    fs->snap.head_len = fs->format == FMT_BINARY ? 0 :
+        game_render_head(g, fs->snap.score, fs->snap.time_sec, fs->snap.head,
+                         (int)sizeof(fs->snap.head));
+}
+
+int frame_encode(FrameState* fs, char* out, int out_cap) {
+    switch (fs->format) {
+    case FMT_DELTA:  return build_text_delta(fs, out, out_cap);
+    case FMT_BINARY: return build_bin_delta(fs, out, out_cap);
+    default:         return build_full(fs, out, out_cap);
+    }
+}
+
+int frame_build(FrameState* fs, const GameState* g, char* out, int out_cap) {
+    frame_capture(fs, g);
+    return frame_encode(fs, out, out_cap);
+}
+
+int frame_build_ack(const FrameState* fs, unsigned seq, unsigned tick,
+                    unsigned wait_us, char* out, int out_cap) {
+    if (fs->format == FMT_BINARY) {
+        if (out_cap < FRAME_HDR_SIZE + FRAME_ACK_SIZE) return 0;
+        bin_header(fs, FRAME_ACK, FRAME_ACK_SIZE, (unsigned char*)out);
+
+        unsigned char* p = (unsigned char*)out + FRAME_HDR_SIZE;
+        put_u32(p, seq);
+        put_u32(p + 4, tick);
+        put_u32(p + 8, wait_us);
+        return FRAME_HDR_SIZE + FRAME_ACK_SIZE;
+    }
+
+    int n = snprintf(out, out_cap, "%s %u %u %u\n", CMD_ACK, seq, tick, wait_us);
+    return n < out_cap ? n : 0;
+}
+
+int frame_build_game_over(FrameState* fs, const GameState* g, int timeout, char* out, int out_cap) {
+    if (fs->format == FMT_BINARY) {
+        if (out_cap < FRAME_HDR_SIZE) return 0;
+        snap_state(fs, g);
+        bin_header(fs, FRAME_GAME_OVER, 0, (unsigned char*)out);
+
+        /* v hlavicke je uplynuly cas (alebo 0 pri vyprsani casu) */
+        int elapsed = (int)(game_elapsed_ms(g) / 1000);
+        unsigned char* p = (unsigned char*)out;
+        p[3] |= timeout ? FRAME_F_TIMEOUT : 0;
+        p[3] |= g->won ? FRAME_F_WIN : 0;
+        put_u32(p + 12, (uint32_t)(timeout ? 0 : elapsed));
+        return FRAME_HDR_SIZE;
+    }
+
+    if (timeout) {
+        return snprintf(out, out_cap,
+            "%s\n%s %d\nMODE TIMED\n%s 0s\n%s\n*** CAS VYPRSAL ***\nENDMAP\n",
+            CMD_GAME_OVER, CMD_SCORE, frame_score(fs, g), CMD_TIME, CMD_MAP);
+    }
+
+    int elapsed = (int)(game_elapsed_ms(g) / 1000);
+
+    if (g->won) {
+        return snprintf(out, out_cap,
+            "%s\n%s\n%s %d\nMODE %s\n%s %ds\n%s\n*** VYHRA - PLNA MAPA ***\nENDMAP\n",
+            CMD_GAME_OVER, CMD_WIN, CMD_SCORE, frame_score(fs, g),
+            g->game_mode == MODE_STANDARD ? "STANDARD" : "TIMED",
+            CMD_TIME, elapsed, CMD_MAP);
+    }
+
+    return snprintf(out, out_cap,
+        "%s\n%s %d\nMODE %s\n%s %ds\n%s\n*** KONIEC HRY ***\nENDMAP\n",
+        CMD_GAME_OVER, CMD_SCORE, frame_score(fs, g),
+        g->game_mode == MODE_STANDARD ? "STANDARD" : "TIMED",
+        CMD_TIME, elapsed, CMD_MAP);
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include "game.h"
+
+/*
+  Format ramcov posielanych klientovi.
+*/
+typedef enum {
+    FMT_FULL,     // kazdy tick cela mapa (SCORE/MODE/TIME + MAP ... ENDMAP)
+    FMT_DELTA,    // raz keyframe, potom len zmenene policka
+    FMT_BINARY    // binarne ramce (FrameHeader v protocol.h), keyframe + delta
+} FrameFormat;
+
+// pocet formatov (napr. jeden stream divakov na format)
+#define FRAME_FORMATS 3
+
+// Kazdych tolko tickov posleme plny ramec aj v rezime DELTA (resync)
+#define KEYFRAME_INTERVAL 20
+
+// hlavicka plneho textoveho ramca (SCORE, MODE, TIME, MAP, banner pauzy)
+#define FRAME_HEAD_CAP 128
+
+/*
+  Stav hry pre jeden ramec, zachyteny pod g->mtx (frame_capture).
+  Ramec sa z neho sklada mimo zamku, hru uz necita.
+*/
+typedef struct {
+    int score;
+    int time_sec;           // do hlavicky (v casovom rezime zostavajuci)
+    int paused;
+    int timed;
+    char head[FRAME_HEAD_CAP];  // hlavicka plneho ramca (len textove formaty)
+    int head_len;
+} FrameSnap;
+
+/*
+  Stav ramcov jedneho klienta: co klient naposledy videl.
+  Klient dostava len vyrez mapy (view), suradnice v deltach su vo vyreze.
+*/
+typedef struct {
+    FrameFormat format;
+    int player;             // z pohladu ktoreho hraca sa mapa sklada (arena),
+                            // VIEWER_SPECTATOR = divak (WATCH)
+    int have_key;           // klient ma platny keyframe
+    int since_key;          // tickov od posledneho keyframe
+    int paused;             // pauza v case posledneho keyframe (banner je v MAP)
+    int rows, cols;         // rozmery vyrezu v poslednom keyframe
+    int score;
+    char time_line[32];
+    MapView view;           // vyrez v tomto ramci (posuva sa za hlavou hraca)
+    char cur[VIEW_ROWS][VIEW_COLS];     // vyrez poskladany pre tento ramec
+    char sent[VIEW_ROWS][VIEW_COLS];    // co klient vidi
+    FrameSnap snap;                     // zvysok stavu hry pre tento ramec
+} FrameState;
+
+void frame_state_init(FrameState* fs, FrameFormat format);
+
+/*
+  Zachyti z hry vsetko, co ramec potrebuje: vyrez okolo hada hraca
+  (fs->view, fs->cur) a fs->snap. Volajuci drzi g->mtx.
+*/
+void frame_capture(FrameState* fs, const GameState* g);
+
+/*
+  Zlozi ramec zo zachyteneho stavu (po frame_capture), hru necita,
+  takze moze bezat mimo g->mtx. Vrati pocet bajtov v out, 0 ak sa nezmesti.
+*/
+int frame_encode(FrameState* fs, char* out, int out_cap);
+
+// frame_capture + frame_encode naraz (pod g->mtx)
+int frame_build(FrameState* fs, const GameState* g, char* out, int out_cap);
+
+/* Potvrdenie aplikovaneho MOVE (ACK) s hlavickou posledneho frame_capture, pred ramcom */
+int frame_build_ack(const FrameState* fs, unsigned seq, unsigned tick,
+                    unsigned wait_us, char* out, int out_cap);
+
+/* Posledny ramec hry (GAME_OVER), timeout = vyprsal cas v casovom rezime */
+int frame_build_game_over(FrameState* fs, const GameState* g, int timeout, char* out, int out_cap);
@@ -1,188 +1,553 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include "game.h"
+#include "../Common/protocol.h"
 #include <string.h>
 #include <stdlib.h>
 #include <time.h>
 #include <stdio.h>
-
-/* Globalne premenne pre velkost mapy */
-int MAP_ROWS = 20;
-int MAP_COLS = 40;
+#include <stdatomic.h>
 
 /*
   Pomocna funkcia ci je (x,y) vnutri pola
 */
-static int in_bounds(int x, int y) {
-    return x >= 0 && x < MAP_COLS && y >= 0 && y < MAP_ROWS;
+static int in_bounds(const GameState* g, int x, int y) {
+    return x >= 0 && x < g->cols && y >= 0 && y < g->rows;
 }
 
+#define PAUSE_BANNER "=== PAUSED (ESC to resume) ===\n"
+
 /*
-  Vycisti board na medzery.
+  Mriezka [rows][cols] v jednom bloku: pole ukazovatelov na riadky, za nim data
+  (vynulovane). Uvolni sa jednym free. NULL ak nie je pamat.
 */
-static void clear_board(GameState* g) {
-    for (int y = 0; y < MAP_ROWS; y++)
-        for (int x = 0; x < MAP_COLS; x++)
-            g->board[y][x] = ' ';
+static char** alloc_char_grid(int rows, int cols) {
+    char** grid = calloc(1, (size_t)rows * sizeof(char*) + (size_t)rows * (size_t)cols);
+    if (!grid) return NULL;
+
+    char* data = (char*)(grid + rows);
+    for (int y = 0; y < rows; y++) grid[y] = data + (size_t)y * (size_t)cols;
+    return grid;
+}
+
+static int** alloc_int_grid(int rows, int cols) {
+    int** grid = calloc(1, (size_t)rows * sizeof(int*) + (size_t)rows * (size_t)cols * sizeof(int));
+    if (!grid) return NULL;
+
+    int* data = (int*)(grid + rows);
+    for (int y = 0; y < rows; y++) grid[y] = data + (size_t)y * (size_t)cols;
+    return grid;
+}
+
+/* Policko vrstvy aj sablony ramca */
+static void layer_set(GameState* g, int x, int y, char c) {
+    g->layer[y][x] = c;
+    if (g->tpl_rows) g->frame_tpl[g->tpl_map + y * (g->cols + 1) + x] = c;
 }
 
 /*
-  Nakresli okrajove steny.
+  Nakresli do layer steny a prekazky (hadi pribudnu v place_snake).
 */
-static void draw_walls(GameState* g, char horiz, char vert) {
-    for (int x = 0; x < MAP_COLS; x++) {
-        g->board[0][x] = horiz;
-        g->board[MAP_ROWS - 1][x] = horiz;
+static void draw_static(GameState* g) {
+    char horiz = g->world == WORLD_WALLS ? '_' : '#';   // WORLD_WALLS: _ a |
+    char vert = g->world == WORLD_WALLS ? '|' : '#';    // WORLD_WRAP: #
+
+    for (int y = 0; y < g->rows; y++) {
+        for (int x = 0; x < g->cols; x++)
+            g->layer[y][x] = g->obstacles[y][x] ? '#' : ' ';
+    }
+    for (int x = 0; x < g->cols; x++) {
+        g->layer[0][x] = horiz;
+        g->layer[g->rows - 1][x] = horiz;
     }
-    for (int y = 0; y < MAP_ROWS; y++) {
-        g->board[y][0] = vert;
-        g->board[y][MAP_COLS - 1] = vert;
+    for (int y = 0; y < g->rows; y++) {
+        g->layer[y][0] = vert;
+        g->layer[y][g->cols - 1] = vert;
     }
 }
 
-/* BFS pre kontrolu dosiahnutelnosti */
-static int is_reachable(GameState* g, int start_x, int start_y) {
-    char visited[MAX_ROWS][MAX_COLS] = {0};
-    int queue_x[MAX_ROWS * MAX_COLS], queue_y[MAX_ROWS * MAX_COLS];
-    int head = 0, tail = 0;
-    
-    queue_x[tail] = start_x;
-    queue_y[tail] = start_y;
-    tail++;
-    visited[start_y][start_x] = 1;
-    int reachable_count = 1;
-    
-    while (head < tail) {
-        int x = queue_x[head];
-        int y = queue_y[head];
-        head++;
-        
-        int dx[] = {0, 0, 1, -1};
-        int dy[] = {1, -1, 0, 0};
-        
-        for (int i = 0; i < 4; i++) {
-            int nx = x + dx[i];
-            int ny = y + dy[i];
-            
-            if (nx > 0 && nx < MAP_COLS - 1 && ny > 0 && ny < MAP_ROWS - 1 &&
-                !visited[ny][nx] && !g->obstacles[ny][nx]) {
-                visited[ny][nx] = 1;
-                queue_x[tail] = nx;
-                queue_y[tail] = ny;
-                tail++;
-                reachable_count++;
-            }
+/* Cislo v do pola sirky w zarovnane doprava (co sa nezmesti, je 9...9) */
+static void put_num(char* p, int w, int v) {
+    if (v < 0) v = 0;
+    for (int i = w - 1; i >= 0; i--) {
+        p[i] = (char)('0' + v % 10);
+        v /= 10;
+        if (v == 0) {
+            memset(p, ' ', (size_t)i);
+            return;
         }
     }
-    
-    /* Pocet volnych policok */
-    int free_count = 0;
-    for (int y = 1; y < MAP_ROWS - 1; y++) {
-        for (int x = 1; x < MAP_COLS - 1; x++) {
-            if (!g->obstacles[y][x]) free_count++;
+    memset(p, '9', (size_t)w);
+}
+
+/*
+  Sablona ramca z vrstvy (po draw_static). Riadky mapy len ak je mapa
+  vo vyreze cela, inak sa do ramca kopiruju z layer.
+*/
+static void build_template(GameState* g) {
+    char* t = g->frame_tpl;
+    int n = sprintf(t, "%s ", CMD_SCORE);
+    g->tpl_score = n;
+    n += TPL_SCORE_WIDTH;
+    n += sprintf(t + n, "\nMODE %s\n%s ", g->game_mode == MODE_STANDARD ? "STANDARD" : "TIMED",
+                 CMD_TIME);
+    g->tpl_time = n;
+    n += TPL_TIME_WIDTH;
+    n += sprintf(t + n, "s%s\n%s\n", g->game_mode == MODE_TIMED ? " LEFT" : "", CMD_MAP);
+    put_num(t + g->tpl_score, TPL_SCORE_WIDTH, 0);
+    put_num(t + g->tpl_time, TPL_TIME_WIDTH, 0);
+
+    g->tpl_map = n;
+    g->tpl_rows = g->rows <= VIEW_ROWS && g->cols <= VIEW_COLS;
+    if (g->tpl_rows) {
+        for (int y = 0; y < g->rows; y++) {
+            memcpy(t + n, g->layer[y], (size_t)g->cols);
+            n += g->cols;
+            t[n++] = '\n';
         }
+        n += sprintf(t + n, "ENDMAP\n");
+    }
+    g->tpl_len = n;
+}
+
+/* Znaky hada p vo vrstve: hrac layer_viewer '@' '*', ostatni 'X' '+' */
+static void layer_chars(const GameState* g, int p, char* head, char* body) {
+    *head = p == g->layer_viewer ? '@' : 'X';
+    *body = p == g->layer_viewer ? '*' : '+';
+}
+
+/* Policko (x,y) mapy je vo vyreze v */
+static int in_view(const MapView* v, int x, int y) {
+    return x >= v->x && x < v->x + v->cols && y >= v->y && y < v->y + v->rows;
+}
+
+/*
+  Nakresli hada p do vyrezu v (grid = lavy horny roh vyrezu, riadky po stride).
+  Prechadza cele telo, kresli len policka vo vyreze.
+*/
+static void paint_snake(const GameState* g, const MapView* v, char* grid, int stride,
+                        int p, char head, char body) {
+    const Snake* s = &g->players[p].snake;
+    int k = s->head;
+    for (int i = 0; i < s->len; i++) {
+        Pos c = s->parts[k];
+        if (in_view(v, c.x, c.y)) grid[(c.y - v->y) * stride + (c.x - v->x)] = (i == 0) ? head : body;
+        if (++k == s->cap) k = 0;
     }
-    
-    return reachable_count == free_count;
 }
 
 /*
-  Generuje nahodne prekazky s kontrolou dosiahnutelnosti
+  Z kopie vrstvy spravi vyrez z pohladu hraca viewer: prekresli hadov,
+  ktorych pohlad sa lisi od layer_viewer, a prida ovocie.
+*/
+static void overlay_viewer(const GameState* g, int viewer, const MapView* v, char* grid, int stride) {
+    if (viewer != g->layer_viewer) {
+        int lv = g->layer_viewer;
+        if (lv >= 0 && g->players[lv].active) paint_snake(g, v, grid, stride, lv, 'X', '+');
+        if (viewer >= 0 && g->players[viewer].active) paint_snake(g, v, grid, stride, viewer, '@', '*');
+    }
+
+    // ovocie hraca, divak vidi vsetko (po vyhre uz nie je); had je nad cudzim ovocim
+    for (int p = 0; p < g->max_players && !g->won; p++) {
+        const Player* pl = &g->players[p];
+        if (!pl->active || (viewer != VIEWER_SPECTATOR && p != viewer)) continue;
+        if (pl->fruit.x < 0 || !in_view(v, pl->fruit.x, pl->fruit.y)) continue;
+        char* c = &grid[(pl->fruit.y - v->y) * stride + (pl->fruit.x - v->x)];
+        if (*c == ' ') *c = 'o';
+    }
+}
+
+/* Policko je vnutri mapy a nie je na nom prekazka */
+static int cell_open(const GameState* g, int x, int y) {
+    return x > 0 && x < g->cols - 1 && y > 0 && y < g->rows - 1 && !g->obstacles[y][x];
+}
+
+/*
+  Lokalna kontrola suvislosti v O(1): prekazka na (x,y) nerozdeli volne
+  policka, ak su vsetky jej volne susedia (hore/dole/vlavo/vpravo) spojeni
+  cez prstenec 8 okolitych policok. Susedne policka v prstenci su susedia
+  aj pri pohybe hada, takze cesty cez (x,y) sa daju obist okolo neho.
+  Podmienka je postacujuca - niektore bezpecne policka odmietne
+  (napr. v uzkej chodbe), vtedy sa len skusi ine policko.
+*/
+static int keeps_connected(const GameState* g, int x, int y) {
+    /* prstenec v poradi S, SV, V, JV, J, JZ, Z, SZ (parne = priami susedia) */
+    static const int rx[8] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+    static const int ry[8] = { -1, -1, 0, 1, 1, 1, 0, -1 };
+    int open[8];
+    int start = -1;
+
+    for (int i = 0; i < 8; i++) {
+        open[i] = cell_open(g, x + rx[i], y + ry[i]);
+        if (!open[i] && start < 0) start = i;
+    }
+    if (start < 0) return 1;   /* cely prstenec volny */
+
+    /* useky volnych policok v prstenci, ktore obsahuju priameho suseda */
+    int runs = 0, in_run = 0, orth = 0;
+    for (int k = 1; k <= 8; k++) {
+        int i = (start + k) % 8;
+        if (open[i]) {
+            if (!in_run) { in_run = 1; orth = 0; }
+            if (i % 2 == 0) orth = 1;
+        }
+        else if (in_run) {
+            runs += orth;
+            in_run = 0;
+        }
+    }
+    return runs <= 1;
+}
+
+/*
+  Generuje nahodne prekazky tak, aby vsetky volne policka ostali
+  navzajom dosiahnutelne. Startovny riadok hada a policko pred hlavou
+  ostavaju volne.
 */
 static void generate_obstacles(GameState* g) {
-    memset(g->obstacles, 0, sizeof(g->obstacles));
-    
-    /* 3-5% policok budu prekazky */
-    int obstacle_count = ((MAP_ROWS - 2) * (MAP_COLS - 2)) / 25;
-    
-    for (int i = 0; i < obstacle_count; i++) {
-        int x, y;
-        do {
-            x = 1 + rand() % (MAP_COLS - 2);
-            y = 1 + rand() % (MAP_ROWS - 2);
-        } while ((x == 1 && y == 1) || g->obstacles[y][x]);
-        
+    /* obstacles su po alokacii prazdne */
+    int inner = (g->rows - 2) * (g->cols - 2);
+    int obstacle_count = inner * g->obstacle_pct / 100;
+    int sx = g->cols / 2;
+    int sy = g->rows / 2;
+
+    /* odmietnute policka sa neratia, pokusov je ale konecne vela */
+    int placed = 0;
+    for (int tries = 0; placed < obstacle_count && tries < obstacle_count * 8; tries++) {
+        int x = 1 + (int)rng_below(&g->rng, (uint32_t)(g->cols - 2));
+        int y = 1 + (int)rng_below(&g->rng, (uint32_t)(g->rows - 2));
+
+        if (g->obstacles[y][x]) continue;
+        if (y == sy && x >= sx - 2 && x <= sx + 1) continue;
+        if (!keeps_connected(g, x, y)) continue;
+
         g->obstacles[y][x] = 1;
-        
-        /* Kontrola dosiahnutelnosti */
-        if (!is_reachable(g, 1, 1)) {
-            g->obstacles[y][x] = 0;  /* Zrus tuto prekazku */
-        }
+        placed++;
     }
 }
 
 /*
-  Zisti, ci had zabera policko (x,y).
+  Zisti, ci had zabera policko (x,y) - O(1) cez occupied[].
   Pouzijeme pre:
   - self-collision
   - aby ovocie nespawnlo na hade
 */
 static int snake_occupies(const GameState* g, int x, int y) {
-    for (int i = 0; i < g->snake.len; i++) {
-        if (g->snake.parts[i].x == x && g->snake.parts[i].y == y) return 1;
+    return g->occupied[y][x];
+}
+
+/* Policko (x,y) je odteraz volne */
+static void free_add(GameState* g, int x, int y) {
+    g->free_pos[y][x] = g->free_count;
+    g->free_cells[g->free_count++] = y * g->cols + x;
+}
+
+/* Policko (x,y) uz nie je volne: na jeho miesto presunieme posledne */
+static void free_remove(GameState* g, int x, int y) {
+    int i = g->free_pos[y][x];
+    if (i < 0) return;
+
+    int last = g->free_cells[--g->free_count];
+    g->free_cells[i] = last;
+    g->free_pos[last / g->cols][last % g->cols] = i;
+    g->free_pos[y][x] = -1;
+}
+
+/* Zoznam volnych policok od nuly (vnutro mapy bez prekazok a hadov) */
+static void free_build(GameState* g) {
+    g->free_count = 0;
+    for (int y = 0; y < g->rows; y++) {
+        for (int x = 0; x < g->cols; x++) {
+            int inner = x > 0 && x < g->cols - 1 && y > 0 && y < g->rows - 1;
+            if (inner && !g->obstacles[y][x] && !snake_occupies(g, x, y)) free_add(g, x, y);
+            else g->free_pos[y][x] = -1;
+        }
     }
+}
+
+/*
+  Spawn ovocia hraca: nahodne volne policko (nie had ani prekazka), vzdy O(1).
+  Ak volne policko nie je, had zaplnil mapu - klasicka hra konci vyhrou,
+  v arene hrac len nema ovocie.
+*/
+static void spawn_fruit(GameState* g, int p) {
+    Player* pl = &g->players[p];
+
+    if (g->free_count == 0) {
+        pl->fruit.x = -1;
+        pl->fruit.y = -1;
+        if (!g->arena) {
+            g->won = 1;
+            g->running = 0;
+        }
+        return;
+    }
+
+    int c = g->free_cells[rng_below(&g->rng, (uint32_t)g->free_count)];
+    pl->fruit.x = c % g->cols;
+    pl->fruit.y = c / g->cols;
+}
+
+/*
+  Plne telo hada: dvojnasobna kapacita, segmenty od hlavy po chvost na zaciatok.
+  0 alebo -1 (nie je pamat, had ostava ako bol).
+*/
+static int snake_grow(Snake* s) {
+    int cap = s->cap ? s->cap * 2 : SNAKE_INIT_CAP;
+    Pos* parts = malloc((size_t)cap * sizeof(*parts));
+    if (!parts) return -1;
+
+    for (int i = 0; i < s->len; i++) parts[i] = snake_part(s, i);
+    free(s->parts);
+    s->parts = parts;
+    s->cap = cap;
+    s->head = 0;
+    s->tail = s->len > 0 ? s->len - 1 : 0;
     return 0;
 }
 
+/* Had dlzky 3 s hlavou na (x,y), telo vlavo, smer doprava (buffer tela uz existuje) */
+static void place_snake(GameState* g, int p, int x, int y) {
+    Snake* s = &g->players[p].snake;
+
+    s->alive = 1;
+    s->len = 3;
+    s->dir = 'd';
+    s->moved_dir = 'd';
+    s->head = 0;
+    s->tail = 2;
+    for (int i = 0; i < s->len; i++) {
+        s->parts[i] = (Pos){ x - i, y };
+        g->occupied[y][x - i] = 1;
+        free_remove(g, x - i, y);
+    }
+
+    char head, body;
+    layer_chars(g, p, &head, &body);
+    for (int i = 0; i < s->len; i++) layer_set(g, x - i, y, i == 0 ? head : body);
+}
+
+/* Telo hada zmizne z mapy (policka su znova volne) */
+static void remove_snake(GameState* g, int p) {
+    Snake* s = &g->players[p].snake;
+
+    for (int i = 0; i < s->len; i++) {
+        Pos c = snake_part(s, i);
+        g->occupied[c.y][c.x] = 0;
+        layer_set(g, c.x, c.y, ' ');
+        free_add(g, c.x, c.y);
+    }
+    s->len = 0;
+    s->alive = 0;
+}
+
+void rng_seed(GameRng* r, uint64_t seed, uint64_t stream) {
+    r->state = 0;
+    r->inc = (stream << 1) | 1;
+    rng_next(r);
+    r->state += seed;
+    rng_next(r);
+}
+
+/* Seed novej hry: cas v ns + poradie hry v procese, premiesane (splitmix64) */
+static unsigned new_seed(void) {
+    static atomic_ulong games;
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+
+    uint64_t z = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec +
+                 atomic_fetch_add(&games, 1) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return (unsigned)(z ^ (z >> 31));
+}
+
+/* Uvolni, co z mriezok a hracov existuje (aj po ciastocnej alokacii) */
+static void free_all(GameState* g) {
+    for (int p = 0; g->players && p < g->max_players; p++) free(g->players[p].snake.parts);
+    free(g->players);
+    g->players = NULL;
+
+    free(g->board);
+    free(g->layer);
+    free(g->obstacles);
+    free(g->occupied);
+    free(g->free_pos);
+    free(g->free_cells);
+    g->board = g->layer = g->obstacles = g->occupied = NULL;
+    g->free_pos = NULL;
+    g->free_cells = NULL;
+}
+
 /*
-  Spawn ovocia: nahodna pozicia, nie na hade ani prekazkach
+  Spolocna inicializacia: mapa, prekazky, volne policka, miesto pre hracov.
+  -1 ak je mapa vacsia ako MAP_DIM_MAX alebo nie je pamat (nic neostane alokovane).
 */
-static void spawn_fruit(GameState* g) {
-    int fx, fy;
-    do {
-        fx = 1 + rand() % (MAP_COLS - 2);
-        fy = 1 + rand() % (MAP_ROWS - 2);
-    } while (snake_occupies(g, fx, fy) || g->obstacles[fy][fx]);
-    g->fruit.x = fx;
-    g->fruit.y = fy;
-}
-
-void game_init(GameState* g, WorldType world, GameMode game_mode, int time_limit_sec,
-               int rows, int cols, int has_obstacles) {
+static int init_common(GameState* g, WorldType world, GameMode game_mode, int time_limit_sec,
+                       int rows, int cols, int obstacle_pct, int max_players, unsigned seed) {
     memset(g, 0, sizeof(*g));
     
-    /* Nastavenie velkosti mapy */
-    MAP_ROWS = rows;
-    MAP_COLS = cols;
+    /* Nastavenie velkosti mapy (najmensia 5x8) */
+    if (rows > MAP_DIM_MAX || cols > MAP_DIM_MAX) return -1;
+    g->rows = rows < 5 ? 5 : rows;
+    g->cols = cols < 8 ? 8 : cols;
+
+    g->max_players = max_players < 1 ? 1 : max_players > MAX_PLAYERS ? MAX_PLAYERS : max_players;
+    g->board = alloc_char_grid(g->rows, g->cols);
+    g->layer = alloc_char_grid(g->rows, g->cols);
+    g->obstacles = alloc_char_grid(g->rows, g->cols);
+    g->occupied = alloc_char_grid(g->rows, g->cols);
+    g->free_pos = alloc_int_grid(g->rows, g->cols);
+    g->free_cells = malloc((size_t)g->rows * (size_t)g->cols * sizeof(int));
+    g->players = calloc((size_t)g->max_players, sizeof(*g->players));
+    if (!g->board || !g->layer || !g->obstacles || !g->occupied || !g->free_pos ||
+        !g->free_cells || !g->players) {
+        free_all(g);
+        return -1;
+    }
 
     pthread_mutex_init(&g->mtx, NULL);
 
-    srand((unsigned)time(NULL));
+    /* rovnaky seed + rovnake prikazy v rovnakych tickoch = rovnaka hra (replay) */
+    g->seed = seed;
+    rng_seed(&g->rng, seed, 0);
     g->running = 1;
-    g->score = 0;
     g->world = world;
     g->game_mode = game_mode;
     g->paused = 0;
     g->time_limit_sec = time_limit_sec;
-    g->start_time = time(NULL);
-    g->pause_start = 0;
-    g->total_pause_time = 0;
-    g->death_time = 0;
-    g->has_obstacles = has_obstacles;
+    g->start_ms = game_now_ms();
+    g->pause_start_ms = 0;
+    g->total_pause_ms = 0;
+    g->obstacle_pct = obstacle_pct < 0 ? 0 : obstacle_pct > 50 ? 50 : obstacle_pct;
+    g->has_obstacles = g->obstacle_pct > 0;
     
     /* Generuj prekazky ak su pozadovane */
-    if (has_obstacles) {
+    if (g->has_obstacles) {
         generate_obstacles(g);
     }
+    free_build(g);
+    draw_static(g);
+    build_template(g);
+    return 0;
+}
+
+int game_init(GameState* g, WorldType world, GameMode game_mode, int time_limit_sec,
+              int rows, int cols, int obstacle_pct) {
+    return game_init_seeded(g, world, game_mode, time_limit_sec, rows, cols, obstacle_pct,
+                            new_seed());
+}
+
+int game_init_seeded(GameState* g, WorldType world, GameMode game_mode, int time_limit_sec,
+                     int rows, int cols, int obstacle_pct, unsigned seed) {
+    if (init_common(g, world, game_mode, time_limit_sec, rows, cols, obstacle_pct, 1, seed) < 0) {
+        return -1;
+    }
+    if (snake_grow(&g->players[0].snake) < 0) {
+        game_destroy(g);
+        return -1;
+    }
+
+    /* Jediny hrac v strede mapy (generate_obstacles tento riadok nechava volny) */
+    g->players[0].active = 1;
+    g->active_players = 1;
+    place_snake(g, 0, g->cols / 2, g->rows / 2);
+    spawn_fruit(g, 0);
+    return 0;
+}
+
+int game_init_arena(GameState* g, WorldType world, int rows, int cols,
+                    int obstacle_pct, int max_players) {
+    if (init_common(g, world, MODE_STANDARD, 0, rows, cols, obstacle_pct, max_players,
+                    new_seed()) < 0) {
+        return -1;
+    }
+    g->arena = 1;
+    g->layer_viewer = VIEWER_SPECTATOR;
+    return 0;
+}
+
+/* Volne policko vnutri mapy (ziadny had, prekazka ani stena) */
+static int cell_free(const GameState* g, int x, int y) {
+    return cell_open(g, x, y) && !snake_occupies(g, x, y);
+}
 
-    /* Inicializacia hada */
-    g->snake.alive = 1;
-    g->snake.len = 3;
-    g->snake.dir = 'd';
+int game_join(GameState* g) {
+    int p = 0;
+    while (p < g->max_players && g->players[p].active) p++;
+    if (p == g->max_players) return -1;
+    if (!g->players[p].snake.parts && snake_grow(&g->players[p].snake) < 0) return -1;
+
+    /* nahodne volne miesto pre hada a policko pred hlavou */
+    for (int tries = 0; tries < 200 && g->free_count > 0; tries++) {
+        int c = g->free_cells[rng_below(&g->rng, (uint32_t)g->free_count)];
+        int x = c % g->cols;
+        int y = c / g->cols;
+
+        if (!cell_free(g, x - 1, y) || !cell_free(g, x - 2, y) || !cell_free(g, x + 1, y)) continue;
+
+        /* novy hrac, buffer tela ostava z predchadzajuceho */
+        Snake* sn = &g->players[p].snake;
+        Pos* parts = sn->parts;
+        int cap = sn->cap;
+        memset(&g->players[p], 0, sizeof(g->players[p]));
+        sn->parts = parts;
+        sn->cap = cap;
+        g->players[p].active = 1;
+        g->active_players++;
+        place_snake(g, p, x, y);
+        spawn_fruit(g, p);
+        return p;
+    }
+    return -1;
+}
+
+void game_leave(GameState* g, int player) {
+    if (player < 0 || player >= g->max_players || !g->players[player].active) return;
+
+    remove_snake(g, player);
+    g->players[player].active = 0;
+    g->active_players--;
+}
+
+void game_destroy(GameState* g) {
+    free_all(g);
+    pthread_mutex_destroy(&g->mtx);
+}
+
+long long game_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000LL + ts.tv_nsec / 1000000;
+}
+
+long long game_elapsed_ms(const GameState* g) {
+    long long now = g->paused ? g->pause_start_ms : game_now_ms();
+    return now - g->start_ms - g->total_pause_ms;
+}
 
-    int sx = MAP_COLS / 2;
-    int sy = MAP_ROWS / 2;
-    g->snake.parts[0] = (Pos){ sx, sy };
-    g->snake.parts[1] = (Pos){ sx - 1, sy };
-    g->snake.parts[2] = (Pos){ sx - 2, sy };
+void game_pause(GameState* g) {
+    if (g->paused) return;
+    g->paused = 1;
+    g->pause_start_ms = game_now_ms();
+}
 
-    spawn_fruit(g);
+void game_resume(GameState* g) {
+    if (!g->paused) return;
+    g->paused = 0;
+    g->total_pause_ms += game_now_ms() - g->pause_start_ms;
 }
 
 /*
   Nastavi smer pohybu z inputu.
   Pridavame ochranu proti otoceniu o 180 stupnov aby sa had nezabil.
 */
-void game_set_dir(GameState* g, char dir) {
-    char cur = g->snake.dir;
+void game_set_dir(GameState* g, int player, char dir) {
+    if (player < 0 || player >= g->max_players) return;
+    Snake* s = &g->players[player].snake;
+
+    /* porovnavame so smerom posledneho kroku, nie s poslednym prikazom */
+    char cur = s->moved_dir;
 
     // zakaz protismer
     if ((cur == 'w' && dir == 's') || (cur == 's' && dir == 'w') ||
@@ -190,22 +555,14 @@ void game_set_dir(GameState* g, char dir) {
 
     // povol len w/a/s/d
     if (dir == 'w' || dir == 'a' || dir == 's' || dir == 'd')
-        g->snake.dir = dir;
+        s->dir = dir;
 }
 
-/*
-  Posun o jeden tick:
-  - vypocita novu hlavu
-  - skontroluje stenu a self-collision
-  - ak zje ovocie -> rast + nove ovocie
-*/
-void game_step(GameState* g) {
-    if (!g->running || !g->snake.alive || g->paused) return;  // nepohybujeme hadom ak je pauza
-
-    Pos head = g->snake.parts[0];
-    Pos nh = head;
+/* Nova pozicia hlavy po kroku; vrati 0 ak had narazil do steny (WORLD_WALLS) */
+static int next_head(const GameState* g, const Snake* s, Pos* out) {
+    Pos nh = snake_head(s);
 
-    switch (g->snake.dir) {
+    switch (s->dir) {
     case 'w': nh.y--; break;
     case 's': nh.y++; break;
     case 'a': nh.x--; break;
@@ -215,109 +572,261 @@ void game_step(GameState* g) {
 
     // WORLD_WRAP: wrap-around na opacny okraj
     if (g->world == WORLD_WRAP) {
-        if (nh.x <= 0) nh.x = MAP_COLS - 2;
-        else if (nh.x >= MAP_COLS - 1) nh.x = 1;
+        if (nh.x <= 0) nh.x = g->cols - 2;
+        else if (nh.x >= g->cols - 1) nh.x = 1;
 
-        if (nh.y <= 0) nh.y = MAP_ROWS - 2;
-        else if (nh.y >= MAP_ROWS - 1) nh.y = 1;
+        if (nh.y <= 0) nh.y = g->rows - 2;
+        else if (nh.y >= g->rows - 1) nh.y = 1;
     }
     // WORLD_WALLS: naraz do steny = koniec
     else if (g->world == WORLD_WALLS) {
-        if (!in_bounds(nh.x, nh.y) || nh.x == 0 || nh.x == MAP_COLS - 1 || nh.y == 0 || nh.y == MAP_ROWS - 1) {
-            g->snake.alive = 0;
-            g->running = 0;  // Okamzite ukoncit hru
-            return;
+        if (!in_bounds(g, nh.x, nh.y) || nh.x == 0 || nh.x == g->cols - 1 || nh.y == 0 || nh.y == g->rows - 1) {
+            return 0;
         }
     }
-    
-    // naraz do prekazky = koniec
-    if (g->has_obstacles && g->obstacles[nh.y][nh.x]) {
-        g->snake.alive = 0;
-        g->running = 0;
-        return;
+
+    *out = nh;
+    return 1;
+}
+
+// docasna znacka v occupied[]: sem uz v tomto ticku vstupila ina hlava
+#define HEAD_MARK 2
+
+/*
+  Posun o jeden tick (vsetci hraci naraz):
+  - vypocita nove hlavy
+  - skontroluje stenu, prekazku a telo (vlastne aj cudzie) cez occupied[]
+  - hlava na hlavu: dve hlavy na tom istom policku = obaja koncia
+  - ak hrac zje svoje ovocie -> rast + nove ovocie
+  Vsetky kontroly su O(1) na hraca, nezavisle od dlzky hadov.
+  V klasickej hre smrt hada ukonci hru, v arene len vyradi hraca.
+*/
+void game_step(GameState* g) {
+    if (!g->running || g->paused) return;  // nepohybujeme hadmi ak je pauza
+
+    int n = g->max_players;
+    Pos nh[MAX_PLAYERS];
+    char moving[MAX_PLAYERS];
+    char dead[MAX_PLAYERS];
+    int ndead = 0;
+
+    // nove hlavy; chvosty este stoja, takze aj vstup na chvost je naraz
+    for (int p = 0; p < n; p++) {
+        Player* pl = &g->players[p];
+        moving[p] = 0;
+        dead[p] = 0;
+        if (!pl->active || !pl->snake.alive) continue;
+
+        if (!next_head(g, &pl->snake, &nh[p]) ||
+            (g->has_obstacles && g->obstacles[nh[p].y][nh[p].x]) ||
+            snake_occupies(g, nh[p].x, nh[p].y)) {
+            dead[p] = 1;
+            ndead++;
+            continue;
+        }
+        moving[p] = 1;
     }
 
-    // naraz do seba = koniec
-    if (snake_occupies(g, nh.x, nh.y)) {
-        g->snake.alive = 0;
+    // hlava na hlavu: prva hlava policko oznaci, dalsia na nom narazi
+    if (n > 1) {
+        for (int p = 0; p < n; p++) {
+            if (!moving[p]) continue;
+            char* c = &g->occupied[nh[p].y][nh[p].x];
+            if (*c != HEAD_MARK) { *c = HEAD_MARK; continue; }
+
+            dead[p] = 1;
+            ndead++;
+            for (int q = 0; q < p; q++) {
+                if (moving[q] && !dead[q] && nh[q].x == nh[p].x && nh[q].y == nh[p].y) {
+                    dead[q] = 1;
+                    ndead++;
+                }
+            }
+        }
+        for (int p = 0; p < n; p++) {
+            if (moving[p]) g->occupied[nh[p].y][nh[p].x] = 0;
+        }
+    }
+
+    // klasicka hra: smrt = koniec hry (had ostava na mape)
+    if (!g->arena && ndead > 0) {
+        g->players[0].snake.alive = 0;
         g->running = 0;  // Okamzite ukoncit hru
         return;
     }
 
-    // zjedol ovocie?
-    int ate = (nh.x == g->fruit.x && nh.y == g->fruit.y);
-    
+    char ate[MAX_PLAYERS];
+    for (int p = 0; p < n; p++) {
+        ate[p] = 0;
+        if (!moving[p] || dead[p]) continue;
+
+        Player* pl = &g->players[p];
+        Snake* s = &pl->snake;
+
+        // zjedol svoje ovocie?
+        ate[p] = (nh[p].x == pl->fruit.x && nh[p].y == pl->fruit.y);
+
+        // ak zje, zvysime dlzku (plny buffer tela sa zvacsi, bez pamate had nenarastie)
+        int grow = 0;
+        if (ate[p]) {
+            pl->score += 10;
+            grow = s->len < s->cap || snake_grow(s) == 0;
+        }
 
-    // ak zje, zvysime dlzku (max MAX_SNAKE)
-    if (ate) {
-        g->score += 10;
-        if (g->snake.len < MAX_SNAKE){
-            g->snake.len++;
+        // posun: nova hlava o slot dozadu, chvost sa posunie len ked had nerastie
+        // occupied[] a layer sa menia len na policku hlavy, starej hlavy a chvosta
+        char head, body;
+        layer_chars(g, p, &head, &body);
+        Pos old = snake_head(s);
+        Pos t = s->parts[s->tail];  // pri plnom bufferi nova hlava prepise slot chvosta
+        layer_set(g, old.x, old.y, body);
+
+        s->head = s->head == 0 ? s->cap - 1 : s->head - 1;
+        s->parts[s->head] = nh[p];
+        g->occupied[nh[p].y][nh[p].x] = 1;
+        layer_set(g, nh[p].x, nh[p].y, head);
+        free_remove(g, nh[p].x, nh[p].y);
+        if (grow) s->len++;
+        else {
+            g->occupied[t.y][t.x] = 0;
+            layer_set(g, t.x, t.y, ' ');
+            free_add(g, t.x, t.y);
+            s->tail = s->tail == 0 ? s->cap - 1 : s->tail - 1;
         }
+        s->moved_dir = s->dir;
     }
 
-    // posun segmentov: od konca k hlave
-    for (int i = g->snake.len - 1; i > 0; i--) {
-        g->snake.parts[i] = g->snake.parts[i - 1];
+    // arena: telo vyradeneho hada zmizne (az po pohybe ostatnych)
+    for (int p = 0; p < n && ndead > 0; p++) {
+        if (dead[p]) remove_snake(g, p);
     }
-    g->snake.parts[0] = nh;
 
     // po zjedeni spawnni nove ovocie
-    if (ate) spawn_fruit(g);
+    for (int p = 0; p < n; p++) {
+        if (ate[p]) spawn_fruit(g, p);
+    }
+}
+
+/* Vyrez s celou mapou */
+static MapView whole_map(const GameState* g) {
+    MapView v = { 0, 0, g->rows, g->cols };
+    return v;
 }
 
 /*
-  Vytvori ASCII mapu do out bufferu.
-  Klient to len to vypise.
+  Zaciatok vyrezu dlzky size na osi dlzky world: ostava, kym je pos aspon
+  stvrtinu vyrezu od jeho okraja, inak sa vyrez prestavi na stred na pos.
 */
-int game_render_map(GameState* g, char* out, int out_cap) {
-    clear_board(g);
-    
-    // Vykresli okraje podla typu sveta
-    if (g->world == WORLD_WALLS) {
-        draw_walls(g, '_', '|');  // WORLD_WALLS: _ a |
-    } else {
-        draw_walls(g, '#', '#');  // WORLD_WRAP: #
+static int follow(int pos, int start, int size, int world) {
+    if (size >= world) return 0;
+
+    int margin = size / 4;
+    if (pos < start + margin || pos >= start + size - margin) start = pos - size / 2;
+    if (start < 0) start = 0;
+    if (start > world - size) start = world - size;
+    return start;
+}
+
+void game_view(const GameState* g, int viewer, MapView* v) {
+    int rows = g->rows < VIEW_ROWS ? g->rows : VIEW_ROWS;
+    int cols = g->cols < VIEW_COLS ? g->cols : VIEW_COLS;
+
+    /* novy vyrez: stred mapy, kym nie je koho sledovat */
+    if (v->rows != rows || v->cols != cols) {
+        v->rows = rows;
+        v->cols = cols;
+        v->x = (g->cols - cols) / 2;
+        v->y = (g->rows - rows) / 2;
     }
-    
-    // Vykresli prekážky
-    if (g->has_obstacles) {
-        for (int y = 1; y < MAP_ROWS - 1; y++) {
-            for (int x = 1; x < MAP_COLS - 1; x++) {
-                if (g->obstacles[y][x]) {
-                    g->board[y][x] = '#';
-                }
-            }
+
+    /* divak sleduje hraca s najvyssim skore */
+    int p = viewer;
+    if (p == VIEWER_SPECTATOR) {
+        for (int q = 0; q < g->max_players; q++) {
+            const Player* pl = &g->players[q];
+            if (pl->active && pl->snake.len > 0 && (p < 0 || pl->score > g->players[p].score)) p = q;
         }
     }
+    if (p < 0 || p >= g->max_players || !g->players[p].active || g->players[p].snake.len == 0) return;
 
-    // ovocie
-    g->board[g->fruit.y][g->fruit.x] = 'o';
+    Pos h = snake_head(&g->players[p].snake);
+    v->x = follow(h.x, v->x, cols, g->cols);
+    v->y = follow(h.y, v->y, rows, g->rows);
+}
 
-    // had: hlava '@', telo '*'
-    for (int i = 0; i < g->snake.len; i++) {
-        int x = g->snake.parts[i].x;
-        int y = g->snake.parts[i].y;
-        g->board[y][x] = (i == 0) ? '@' : '*';
-    }
+void game_compose_view(const GameState* g, int viewer, const MapView* v, char* out, int stride) {
+    for (int y = 0; y < v->rows; y++)
+        memcpy(out + y * stride, g->layer[v->y + y] + v->x, (size_t)v->cols);
+    overlay_viewer(g, viewer, v, out, stride);
+}
 
-    // zlozenie textu do out
-    int n = 0;
-    n += snprintf(out + n, out_cap - n, "MAP\n");
+/*
+  Poskladaj board zo stavu hry z pohladu hraca viewer.
+*/
+void game_compose_board(GameState* g, int viewer) {
+    MapView v = whole_map(g);
+    game_compose_view(g, viewer, &v, g->board[0], g->cols);
+}
 
-    // Ak je pauza, pridat PAUSED indikator
-    if (g->paused) {
-        n += snprintf(out + n, out_cap - n, "=== PAUSED (ESC to resume) ===\n");
-    }
+/* Bajty riadkov vyrezu v texte (riadky s '\n' + ENDMAP) */
+static int view_text_len(const MapView* v) {
+    return v->rows * (v->cols + 1) + (int)strlen("ENDMAP\n");
+}
 
-    for (int y = 0; y < ROWS; y++) {
-        for (int x = 0; x < COLS; x++) {
-            if (n >= out_cap - 2) break; // ochrana bufferu
-            out[n++] = g->board[y][x];
+/*
+  Riadky vyrezu v z pohladu hraca viewer do out (kazdy s '\n') a ENDMAP.
+  Cela mapa zo sablony, inak riadky vyrezu z layer. Vrati pocet bajtov.
+*/
+static int render_view(const GameState* g, int viewer, const MapView* v, char* out) {
+    int n = 0;
+    if (g->tpl_rows && v->rows == g->rows && v->cols == g->cols) {
+        n = g->tpl_len - g->tpl_map;
+        memcpy(out, g->frame_tpl + g->tpl_map, (size_t)n);
+    }
+    else {
+        for (int y = 0; y < v->rows; y++) {
+            memcpy(out + n, g->layer[v->y + y] + v->x, (size_t)v->cols);
+            n += v->cols;
+            out[n++] = '\n';
         }
-        if (n < out_cap - 1) out[n++] = '\n';
+        memcpy(out + n, "ENDMAP\n", strlen("ENDMAP\n"));
+        n += (int)strlen("ENDMAP\n");
     }
-
-    n += snprintf(out + n, out_cap - n, "ENDMAP\n");
+    overlay_viewer(g, viewer, v, out, v->cols + 1);
     return n;
 }
+
+/*
+  Vytvori ASCII mapu do out bufferu.
+  Klient to len to vypise.
+*/
+int game_render_map(GameState* g, int viewer, char* out, int out_cap) {
+    /* "MAP\n" + [PAUSED] + riadky a ENDMAP (zo sablony) */
+    MapView v = whole_map(g);
+    int head = (int)strlen(CMD_MAP) + 1;
+    int banner = g->paused ? (int)strlen(PAUSE_BANNER) : 0;
+    if (head + banner + view_text_len(&v) > out_cap) return 0;  // ochrana bufferu
+
+    memcpy(out, g->frame_tpl + g->tpl_map - head, (size_t)head);
+    memcpy(out + head, PAUSE_BANNER, (size_t)banner);
+    return head + banner + render_view(g, viewer, &v, out + head + banner);
+}
+
+int game_render_head(const GameState* g, int score, int time_sec, char* out, int out_cap) {
+    int banner = g->paused ? (int)strlen(PAUSE_BANNER) : 0;
+    if (g->tpl_map + banner > out_cap) return 0;
+
+    /* hlavicka po "MAP\n" a pauza, potom len cisla */
+    memcpy(out, g->frame_tpl, (size_t)g->tpl_map);
+    memcpy(out + g->tpl_map, PAUSE_BANNER, (size_t)banner);
+    put_num(out + g->tpl_score, TPL_SCORE_WIDTH, score);
+    put_num(out + g->tpl_time, TPL_TIME_WIDTH, time_sec);
+    return g->tpl_map + banner;
+}
+
+int game_render_frame(const GameState* g, int viewer, const MapView* v, int score, int time_sec,
+                      char* out, int out_cap) {
+    int head = game_render_head(g, score, time_sec, out, out_cap);
+    if (head == 0 || head + view_text_len(v) > out_cap) return 0;
+    return head + render_view(g, viewer, v, out + head);
+}
@@ -1,17 +1,21 @@
 #pragma once
 #include <pthread.h>
+#include <stdint.h>
 #include <time.h>
 
 /*
-  Rozmery mapy (budu sa menit podla vyberu)
+  Absolutna hranica rozmeru mapy (index policka y*cols+x sa zmesti do int).
+  Skutocne rozmery su v GameState, mriezky sa alokuju podla nich v game_init;
+  kolko povoli klientom server, je jeho nastavenie (server -M).
 */
-extern int MAP_ROWS;
-extern int MAP_COLS;
+#define MAP_DIM_MAX 10000
 
-#define MAX_ROWS 30
-#define MAX_COLS 60
-#define ROWS MAP_ROWS
-#define COLS MAP_COLS
+/*
+  Najvacsi vyrez mapy, ktory sa posiela klientovi (velkost terminalu klienta).
+  Mensia mapa ide cela, vacsia len ako vyrez okolo hlavy hraca (MapView).
+*/
+#define VIEW_ROWS 30
+#define VIEW_COLS 60
 
 /*
   Typ sveta: so stenami alebo wrap-around
@@ -29,8 +33,11 @@ typedef enum {
     MODE_TIMED        // casovy rezim (hra konci po uplynutí casu)
 } GameMode;
 
-//Max dlzka hada
-#define MAX_SNAKE 256
+// Predvolena hustota prekazok (percento vnutra mapy) pre OBS
+#define OBSTACLE_PCT 4
+
+// Pociatocna kapacita tela hada (rastie zdvojnasobenim, had moze zaplnit celu mapu)
+#define SNAKE_INIT_CAP 64
 
 // pozicia v mriezke
 typedef struct {
@@ -39,49 +46,226 @@ typedef struct {
 
 /*
   Snake = "objekt" v C (struct).
-  - parts[]: segmenty hada (0 je hlava)
+  - parts[]: kruhovy buffer segmentov (cap miest), hlava je parts[head], chvost
+    parts[tail], segmenty idu od hlavy k chvostu so stupajucim indexom (modulo cap).
+    Posun o krok = novy head o jedno dozadu + posun tail, bez kopirovania tela.
+    Plny buffer sa pri raste zdvojnasobi (game_step).
+  - head/tail: indexy hlavy a chvosta v parts[]
   - len: aktualna dlzka
   - dir: smer pohybu ('w','a','s','d')
+  - moved_dir: smer posledneho kroku (ochrana proti otoceniu o 180
+    aj ked pride viac prikazov medzi dvoma tickmi)
   - alive/running: stav hry
 */
 typedef struct {
-    Pos parts[MAX_SNAKE];
+    Pos* parts;
+    int cap;
+    int head;
+    int tail;
     int len;
     char dir;
+    char moved_dir;
     int alive;
 } Snake;
 
+// i-ty segment hada (0 = hlava)
+static inline Pos snake_part(const Snake* s, int i) {
+    int k = s->head + i;
+    if (k >= s->cap) k -= s->cap;
+    return s->parts[k];
+}
+
+static inline Pos snake_head(const Snake* s) {
+    return s->parts[s->head];
+}
+
 /*
-  GameState = kompletny stav hry na serveri.
+  Generator nahody hry (PCG32): kazda hra ma vlastny stav, takze hry
+  v roznych vlaknach sa nezdrzuju zamkom v rand() ani si nemiesaju sekvencie.
+*/
+typedef struct {
+    uint64_t state;
+    uint64_t inc;       // cislo prudu (vzdy neparne)
+} GameRng;
+
+void rng_seed(GameRng* r, uint64_t seed, uint64_t stream);
+
+static inline uint32_t rng_next(GameRng* r) {
+    uint64_t old = r->state;
+    r->state = old * 6364136223846793005ULL + r->inc;
+    uint32_t xorshifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+    uint32_t rot = (uint32_t)(old >> 59);
+    return (xorshifted >> rot) | (xorshifted << ((-rot) & 31));
+}
+
+// Rovnomerne 0..n-1 (nasobenie namiesto modulo, n > 0)
+static inline uint32_t rng_below(GameRng* r, uint32_t n) {
+    return (uint32_t)(((uint64_t)rng_next(r) * n) >> 32);
+}
+
+// Sablona ramca: hlavicka + MAP + riadky s '\n' + ENDMAP (riadky len ked je mapa vo vyreze cela)
+#define FRAME_TPL_CAP (128 + VIEW_ROWS * (VIEW_COLS + 1))
+#define TPL_SCORE_WIDTH 10
+#define TPL_TIME_WIDTH 7
+
+// Max pocet hracov v arene (viac hadov na jednej mape)
+#define MAX_PLAYERS 64
+
+/*
+  Player = jeden hrac: jeho had, jeho ovocie a skore.
+  Klasicka hra ma jedneho hraca (index 0), arena ich ma viac na spolocnej mape.
 */
 typedef struct {
-    char board[MAX_ROWS][MAX_COLS];
-    char obstacles[MAX_ROWS][MAX_COLS];
     Snake snake;
-    Pos fruit;
-    int running;
+    Pos fruit;          // ovocie tohto hraca, vidi a zje ho len on (-1,-1 = ziadne)
     int score;
+    int active;         // slot je obsadeny (hrac sa pripojil a neodisiel)
+} Player;
+
+/*
+  GameState = kompletny stav hry na serveri.
+  Vsetky funkcie hry pracuju len s tymto stavom (ziadne globalne premenne),
+  takze v jednom procese moze bezat viac hier roznej velkosti naraz.
+*/
+typedef struct {
+    int rows, cols;
+
+    /* mriezky [rows][cols] (pole riadkov, alokuje game_init, uvolni game_destroy) */
+    char** board;       // cela mapa z pohladu jedneho hraca (game_compose_board)
+
+    /*
+      Trvala vrstva mapy: steny, prekazky a hadi (bez ovocia) z pohladu
+      hraca layer_viewer. Kresli sa raz pri inicializacii, potom ju game_step
+      meni len na zmenenych polickach (nova hlava, stara hlava, chvost).
+    */
+    char** layer;
+    int layer_viewer;   // klasicka hra 0, arena VIEWER_SPECTATOR
+
+    /*
+      Sablona plneho textoveho ramca z layer: SCORE a TIME s cislami pevnej
+      sirky, MODE, MAP, riadky mapy uz s '\n', ENDMAP. Vytvori sa pri
+      inicializacii, zapis do layer ide aj sem. Ramec = kopia sablony
+      a prepisanie par bajtov (cisla, ovocie). Mapa vacsia ako vyrez
+      ma v sablone len hlavicku, riadky vyrezu sa beru z layer.
+    */
+    char frame_tpl[FRAME_TPL_CAP];
+    int tpl_len;
+    int tpl_score, tpl_time;    // offset cisla SCORE / TIME
+    int tpl_map;                // offset prveho riadku mapy (za "MAP\n")
+    int tpl_rows;               // riadky celej mapy su v sablone
+
+    char** obstacles;
+    char** occupied;    // 1 = policko zabera niektory had (udrzuje game_step)
+
+    /*
+      Volne policka (vnutro mapy bez prekazok a hada):
+      free_cells[0..free_count) = y * cols + x, free_pos = index v free_cells
+      alebo -1. Pridanie/odobratie v O(1) (odobratie = swap s poslednym).
+    */
+    int* free_cells;
+    int** free_pos;
+    int free_count;
+
+    Player* players;    // max_players hracov (alokuje game_init, uvolni game_destroy)
+    int max_players;
+    int active_players;
+    int arena;          // viac hracov: smrt hada neukonci hru, len vyradi hraca
+
+    int running;
     WorldType world;
     GameMode game_mode;
     int paused;
     int time_limit_sec;
-    time_t start_time;
-    time_t pause_start;
-    int total_pause_time;
-    time_t death_time;
+    long long start_ms;        // cas v ms podla CLOCK_MONOTONIC (game_now_ms)
+    long long pause_start_ms;
+    long long total_pause_ms;
     int has_obstacles;
+    int obstacle_pct;   // hustota prekazok v % (0 = bez prekazok)
+    int won;            // had zaplnil celu mapu, hra skoncila vyhrou
+    unsigned seed;      // seed nahody (prekazky, ovocie), zapisuje sa do zaznamu hry
+    GameRng rng;
     pthread_mutex_t mtx;
 } GameState;
 
-void game_init(GameState* g, WorldType world, GameMode game_mode, int time_limit_sec,
-               int rows, int cols, int has_obstacles);
+/*
+  Nova hra. obstacle_pct = kolko percent vnutra mapy budu prekazky
+  (0 = bez prekazok, OBSTACLE_PCT = klasicke OBS).
+  0, alebo -1 ak je mapa vacsia ako MAP_DIM_MAX alebo nie je pamat
+  (vtedy nie je co uvolnovat, game_destroy sa nevola).
+*/
+int game_init(GameState* g, WorldType world, GameMode game_mode, int time_limit_sec,
+              int rows, int cols, int obstacle_pct);
+
+/*
+  Ako game_init, ale s danym seedom nahody (replay zaznamu hry).
+  game_init vyberie seed sam (kazda hra iny, aj ked vznikne v tej istej sekunde).
+*/
+int game_init_seeded(GameState* g, WorldType world, GameMode game_mode, int time_limit_sec,
+                     int rows, int cols, int obstacle_pct, unsigned seed);
+
+/*
+  Arena: spolocna mapa pre az max_players hracov, zatial bez hracov.
+  Hraci sa pridavaju game_join a odchadzaju game_leave.
+*/
+int game_init_arena(GameState* g, WorldType world, int rows, int cols,
+                    int obstacle_pct, int max_players);
+
+// Novy had v arene na nahodnom volnom mieste. Vrati index hraca alebo -1 (plno, bez pamate)
+int game_join(GameState* g);
+
+// Hrac odchadza, jeho telo zmizne z mapy
+void game_leave(GameState* g, int player);
+
+// Uvolni mriezky, hracov a mutex (po game_init / game_init_arena)
+void game_destroy(GameState* g);
 
-// Nastavenie smeru pohybu (vola sa zo serveroveho receive threadu)
-void game_set_dir(GameState* g, char dir);
+// Monotonny cas v milisekundach (nezavisi od zmeny systemoveho casu)
+long long game_now_ms(void);
+
+// Cas hry v ms bez pauz (pocas pauzy stoji)
+long long game_elapsed_ms(const GameState* g);
+
+// Pauza / pokracovanie (zapocita cas pauzy)
+void game_pause(GameState* g);
+void game_resume(GameState* g);
+
+// Nastavenie smeru pohybu hraca (vola sa zo serveroveho receive threadu)
+void game_set_dir(GameState* g, int player, char dir);
 
 // Posun hry o 1 tick (server game loop)
 void game_step(GameState* g);
 
+// viewer pre divaka (WATCH): vsetci hadi ako 'X' '+', vsetko ovocie
+#define VIEWER_SPECTATOR -1
+
+/*
+  Vyrez mapy, ktory vidi klient: lavy horny roh (x, y) a rozmery.
+*/
+typedef struct {
+    int x, y;
+    int rows, cols;     // 0 = este nenastaveny
+} MapView;
+
+/*
+  Posunie vyrez v za hlavou hraca viewer (divak sleduje hraca s najvyssim
+  skore). Mapa do VIEW_ROWS x VIEW_COLS je vo vyreze cela. Vyrez sa
+  neposuva s kazdym krokom: prestavi sa na stred, az ked je hlava blizko
+  jeho okraja, takze delty ostavaju male.
+*/
+void game_view(const GameState* g, int viewer, MapView* v);
+
+/*
+  Poskladaj vyrez v z pohladu hraca viewer do out (riadky po stride bajtoch).
+*/
+void game_compose_view(const GameState* g, int viewer, const MapView* v, char* out, int stride);
+
+/*
+  Poskladaj aktualny stav do g->board z pohladu hraca viewer:
+  steny, prekazky, jeho ovocie, jeho had ('@' '*') a ostatni hadi ('X' '+').
+  Kopia g->layer po riadkoch, prekreslia sa len hadi, ktorych pohlad sa lisi.
+*/
+void game_compose_board(GameState* g, int viewer);
+
 /*
   Vytvori textovu mapu do bufferu (out).
   Format:
@@ -89,4 +273,18 @@ void game_step(GameState* g);
     <ROWS riadkov>\n
     ENDMAP\n
 */
-int game_render_map(GameState* g, char* out, int out_cap);
+int game_render_map(GameState* g, int viewer, char* out, int out_cap);
+
+/*
+  Plny textovy ramec zo sablony: SCORE score, MODE, TIME time_sec (v casovom
+  rezime "LEFT"), MAP ... ENDMAP s vyrezom v z pohladu hraca viewer. Cisla su
+  zarovnane doprava medzerami. Vrati pocet bajtov, 0 ak sa nezmesti do out_cap.
+*/
+int game_render_frame(const GameState* g, int viewer, const MapView* v, int score, int time_sec,
+                      char* out, int out_cap);
+
+/*
+  Len hlavicka plneho ramca zo sablony: SCORE, MODE, TIME, MAP (a banner
+  pauzy). Riadky mapy doplni volajuci. Vrati pocet bajtov, 0 ak sa nezmesti.
+*/
+int game_render_head(const GameState* g, int score, int time_sec, char* out, int out_cap);
@@ -0,0 +1,245 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../Common/protocol.h"
+#include "gamelog.h"
+
+static void put_varint(FILE* f, unsigned v) {
+    while (v >= 0x80) {
+        fputc((int)(v & 0x7F) | 0x80, f);
+        v >>= 7;
+    }
+    fputc((int)v, f);
+}
+
+static int get_varint(const unsigned char* p, long n, long* pos, unsigned* v) {
+    unsigned r = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (*pos >= n) return -1;
+        unsigned char b = p[(*pos)++];
+        r |= (unsigned)(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            *v = r;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+static void put_u32_file(FILE* f, uint32_t v) {
+    unsigned char b[4];
+    put_u32(b, v);
+    fwrite(b, 1, 4, f);
+}
+
+uint32_t gamelog_hash(const GameState* g) {
+    /* FNV-1a */
+    uint32_t h = 2166136261u;
+#define MIX(byte) (h = (h ^ (unsigned char)(byte)) * 16777619u)
+
+    for (int y = 0; y < g->rows; y++) {
+        for (int x = 0; x < g->cols; x++) MIX(g->occupied[y][x]);
+    }
+    const Player* pl = &g->players[0];
+    Pos head = snake_head(&pl->snake);
+    int vals[] = { pl->fruit.x, pl->fruit.y, pl->score, pl->snake.len, head.x, head.y,
+                   pl->snake.alive, g->won };
+    for (size_t i = 0; i < sizeof(vals) / sizeof(vals[0]); i++) {
+        for (int k = 0; k < 4; k++) MIX(vals[i] >> (8 * k));
+    }
+#undef MIX
+    return h;
+}
+
+int gamelog_open(GameLogWriter* w, const char* path, const GameState* g, int tick_ms) {
+    memset(w, 0, sizeof(*w));
+    w->f = fopen(path, "wb");
+    if (!w->f) { perror("fopen"); return -1; }
+
+    unsigned char h[GAMELOG_HDR_SIZE] = { 0 };
+    put_u32(h, GAMELOG_MAGIC);
+    h[4] = GAMELOG_VERSION;
+    h[5] = (unsigned char)g->world;
+    h[6] = (unsigned char)g->game_mode;
+    h[7] = (unsigned char)g->obstacle_pct;
+    put_u16(h + 8, (uint16_t)g->rows);
+    put_u16(h + 10, (uint16_t)g->cols);
+    put_u16(h + 12, (uint16_t)g->time_limit_sec);
+    put_u16(h + 14, (uint16_t)tick_ms);
+    put_u32(h + 16, g->seed);
+    fwrite(h, 1, sizeof(h), w->f);
+    return 0;
+}
+
+void gamelog_cmd(GameLogWriter* w, unsigned tick, char cmd) {
+    if (!w->f) return;
+    fputc(GAMELOG_CMD, w->f);
+    put_varint(w->f, tick - w->last_tick);
+    fputc(cmd, w->f);
+    w->last_tick = tick;
+    w->cmds++;
+}
+
+void gamelog_end(GameLogWriter* w, unsigned tick, int stopped, const GameState* g) {
+    if (!w->f) return;
+
+    const Player* pl = &g->players[0];
+    fputc(GAMELOG_END, w->f);
+    put_varint(w->f, tick - w->last_tick);
+    fputc(stopped ? 1 : 0, w->f);
+    put_u32_file(w->f, (uint32_t)pl->score);
+    put_u32_file(w->f, (uint32_t)pl->snake.len);
+    fputc(g->won ? 1 : 0, w->f);
+    put_u32_file(w->f, gamelog_hash(g));
+
+    fclose(w->f);
+    w->f = NULL;
+}
+
+/* Cely subor do pamate */
+static unsigned char* read_file(const char* path, long* n) {
+    FILE* f = fopen(path, "rb");
+    if (!f) { perror(path); return NULL; }
+
+    fseek(f, 0, SEEK_END);
+    *n = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    unsigned char* p = malloc(*n > 0 ? (size_t)*n : 1);
+    if (p && fread(p, 1, (size_t)*n, f) != (size_t)*n) {
+        free(p);
+        p = NULL;
+    }
+    fclose(f);
+    if (!p) fprintf(stderr, "%s: chyba citania\n", path);
+    return p;
+}
+
+int gamelog_load(GameLog* log, const char* path) {
+    memset(log, 0, sizeof(*log));
+
+    long n;
+    unsigned char* p = read_file(path, &n);
+    if (!p) return -1;
+
+    if (n < GAMELOG_HDR_SIZE || get_u32(p) != GAMELOG_MAGIC || p[4] != GAMELOG_VERSION) {
+        fprintf(stderr, "%s: nie je zaznam hry (verzia %d)\n", path, GAMELOG_VERSION);
+        free(p);
+        return -1;
+    }
+
+    GameLogHeader* h = &log->h;
+    h->world = (WorldType)p[5];
+    h->mode = (GameMode)p[6];
+    h->obstacle_pct = p[7];
+    h->rows = get_u16(p + 8);
+    h->cols = get_u16(p + 10);
+    h->time_limit = get_u16(p + 12);
+    h->tick_ms = get_u16(p + 14);
+    h->seed = get_u32(p + 16);
+
+    /* kazdy prikaz ma aspon 3 bajty */
+    log->cmds = malloc((size_t)(n / 3 + 1) * sizeof(*log->cmds));
+    if (!log->cmds) { perror("malloc"); free(p); return -1; }
+
+    long pos = GAMELOG_HDR_SIZE;
+    unsigned tick = 0;
+    int bad = 0;
+    while (pos < n && !bad) {
+        unsigned d;
+        char tag = (char)p[pos];
+
+        if (tag == GAMELOG_END) {
+            pos++;
+            if (get_varint(p, n, &pos, &d) < 0 || n - pos < 14) { bad = 1; break; }
+            GameLogEnd* e = &log->end;
+            e->tick = tick + d;
+            e->stopped = p[pos];
+            e->score = (int)get_u32(p + pos + 1);
+            e->len = (int)get_u32(p + pos + 5);
+            e->won = p[pos + 9];
+            e->hash = get_u32(p + pos + 10);
+            log->has_end = 1;
+            break;
+        }
+
+        if (tag != GAMELOG_CMD) { bad = 1; break; }
+        pos++;
+        if (get_varint(p, n, &pos, &d) < 0 || pos >= n) { bad = 1; break; }
+        tick += d;
+        log->cmds[log->ncmds].tick = tick;
+        log->cmds[log->ncmds].cmd = (char)p[pos++];
+        log->ncmds++;
+    }
+    free(p);
+
+    if (bad) {
+        fprintf(stderr, "%s: poskodeny zaznam (po %d prikazoch)\n", path, log->ncmds);
+        gamelog_free(log);
+        return -1;
+    }
+    return 0;
+}
+
+void gamelog_free(GameLog* log) {
+    free(log->cmds);
+    log->cmds = NULL;
+    log->ncmds = 0;
+}
+
+/* Prikaz zo zaznamu, rovnake pravidla ako session_apply_input v klasickej hre */
+static void apply(GameState* g, char cmd) {
+    switch (cmd) {
+    case GAMELOG_PAUSE:
+        if (!g->paused) game_pause(g);
+        break;
+    case GAMELOG_RESUME:
+        if (g->paused) game_resume(g);
+        break;
+    case GAMELOG_QUIT:
+        g->running = 0;
+        break;
+    default:
+        /* MOVE len v stave RUNNING (nie v pauze) */
+        if (!g->paused) game_set_dir(g, 0, cmd);
+        break;
+    }
+}
+
+int gamelog_replay(const GameLog* log, GameState* g, ReplayResult* r) {
+    const GameLogHeader* h = &log->h;
+    memset(r, 0, sizeof(*r));
+    if (game_init_seeded(g, h->world, h->mode, h->time_limit, h->rows, h->cols,
+                         h->obstacle_pct, h->seed) < 0) {
+        fprintf(stderr, "replay: hru %dx%d sa nepodarilo vytvorit\n", h->rows, h->cols);
+        return -1;
+    }
+
+    /* bez konca: po posledny prikaz */
+    unsigned last = log->has_end ? log->end.tick
+                                 : (log->ncmds ? log->cmds[log->ncmds - 1].tick : 0);
+    int i = 0;
+    unsigned t = 0;
+    for (; t <= last; t++) {
+        while (i < log->ncmds && log->cmds[i].tick == t) apply(g, log->cmds[i++].cmd);
+
+        /* cas alebo odpojenie: v tomto ticku uz game_step nebezal */
+        if (log->has_end && t == log->end.tick && log->end.stopped) g->running = 0;
+
+        game_step(g);
+        if (!g->running) break;
+    }
+
+    const Player* pl = &g->players[0];
+    r->ticks = t;
+    r->score = pl->score;
+    r->len = pl->snake.len;
+    r->won = g->won;
+    r->hash = gamelog_hash(g);
+    game_destroy(g);
+
+    if (!log->has_end) return -1;
+    return r->ticks == log->end.tick && r->score == log->end.score && r->len == log->end.len &&
+           r->won == log->end.won && r->hash == log->end.hash;
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <stdio.h>
+#include <stdint.h>
+
+#include "game.h"
+
+/*
+ * Zaznam hry: seed, parametre a kazdy aplikovany prikaz s cislom ticku.
+ * Z toho sa da hra headless prehrat cez game_step (gamelog_replay) -
+ * rovnaky seed a rovnake prikazy v rovnakych tickoch daju rovnaku hru.
+ *
+ * Subor (cisla big-endian ako v protocol.h):
+ *   hlavicka GAMELOG_HDR_SIZE B: magic, verzia, svet, rezim, prekazky %,
+ *            rows, cols, casovy limit, perioda ticku ms, seed
+ *   prikazy: 'C', rozdiel tickov (varint), znak prikazu (w a s d P R Q)
+ *   koniec:  'E', rozdiel tickov (varint), stopped, skore, dlzka, vyhra, hash
+ * Kazdy zaznam zacina znackou, bajt varintu sa tak nezamiena so znackou konca.
+ * Prikaz sa aplikuje v ticku pred game_step (ako session_apply_input).
+ */
+#define GAMELOG_MAGIC 0x534E4C47u   // "SNLG"
+#define GAMELOG_VERSION 2
+#define GAMELOG_HDR_SIZE 24
+
+// prikazy v zazname (MOVE = smer)
+#define GAMELOG_PAUSE 'P'
+#define GAMELOG_RESUME 'R'
+#define GAMELOG_QUIT 'Q'
+
+// znacky zaznamov v subore
+#define GAMELOG_CMD 'C'
+#define GAMELOG_END 'E'
+
+typedef struct {
+    WorldType world;
+    GameMode mode;
+    int obstacle_pct;
+    int rows, cols;
+    int time_limit;
+    int tick_ms;
+    unsigned seed;
+} GameLogHeader;
+
+typedef struct {
+    unsigned tick;
+    char cmd;
+} GameLogCmd;
+
+/* Koniec hry v zazname, replay ho musi zopakovat */
+typedef struct {
+    unsigned tick;      // tick, v ktorom hra skoncila
+    int stopped;        // hru ukoncil cas alebo odpojenie, nie game_step
+    int score;
+    int len;
+    int won;
+    uint32_t hash;      // gamelog_hash na konci
+} GameLogEnd;
+
+/* Zapis pocas hry */
+typedef struct {
+    FILE* f;
+    unsigned last_tick;
+    long cmds;
+} GameLogWriter;
+
+// Otvori subor a zapise hlavicku z prave inicializovanej hry. 0 alebo -1
+int gamelog_open(GameLogWriter* w, const char* path, const GameState* g, int tick_ms);
+
+void gamelog_cmd(GameLogWriter* w, unsigned tick, char cmd);
+
+// Zapise koniec hry a zavrie subor
+void gamelog_end(GameLogWriter* w, unsigned tick, int stopped, const GameState* g);
+
+/* Nacitany zaznam */
+typedef struct {
+    GameLogHeader h;
+    GameLogCmd* cmds;
+    int ncmds;
+    int has_end;        // zaznam bez konca (server skoncil pocas hry) sa prehra po posledny prikaz
+    GameLogEnd end;
+} GameLog;
+
+// Nacita cely subor. 0 alebo -1 (chybny subor, chyba sa vypise)
+int gamelog_load(GameLog* log, const char* path);
+
+void gamelog_free(GameLog* log);
+
+typedef struct {
+    unsigned ticks;     // odsimulovane ticky
+    int score, len, won;
+    uint32_t hash;
+} ReplayResult;
+
+/*
+  Prehra zaznam do g (g sa inicializuje a na konci uvolni).
+  Vrati 1 ak sa koniec zhoduje so zaznamom, 0 ak nie, -1 ak zaznam nema koniec
+  alebo sa hra neda vytvorit.
+*/
+int gamelog_replay(const GameLog* log, GameState* g, ReplayResult* r);
+
+// Otlacok stavu klasickej hry (telo hada, ovocie, skore) na porovnanie
+uint32_t gamelog_hash(const GameState* g);
@@ -0,0 +1,36 @@
+#include "input_queue.h"
+
+#define MASK (INPUT_QUEUE_CAP - 1)
+
+void input_queue_init(InputQueue* q) {
+    atomic_init(&q->head, 0);
+    atomic_init(&q->tail, 0);
+    atomic_init(&q->full, 0);
+}
+
+int input_push(InputQueue* q, const InputCmd* c) {
+    unsigned t = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    unsigned h = atomic_load_explicit(&q->head, memory_order_acquire);
+
+    if (t - h == INPUT_QUEUE_CAP) {
+        atomic_fetch_add_explicit(&q->full, 1, memory_order_relaxed);
+        return 0;
+    }
+
+    q->cmds[t & MASK] = *c;
+    /* citatel uvidi prikaz az s novym tail */
+    atomic_store_explicit(&q->tail, t + 1, memory_order_release);
+    return 1;
+}
+
+int input_pop(InputQueue* q, InputCmd* c) {
+    unsigned h = atomic_load_explicit(&q->head, memory_order_relaxed);
+    unsigned t = atomic_load_explicit(&q->tail, memory_order_acquire);
+
+    if (h == t) return 0;
+
+    *c = q->cmds[h & MASK];
+    /* az teraz moze zapisovatel miesto prepisat */
+    atomic_store_explicit(&q->head, h + 1, memory_order_release);
+    return 1;
+}
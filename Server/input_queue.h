@@ -0,0 +1,40 @@
+#pragma once
+#include <stdatomic.h>
+
+/*
+ * Fronta prikazov od klienta pre game loop: jeden zapisovatel (recv thread),
+ * jeden citatel (tick). Bez mutexu - zapisovatel posuva len tail, citatel
+ * len head (C11 atomiky, release/acquire).
+ * Plna fronta prikaz neprijme - zapisovatel ho podrzi a prestane citat socket,
+ * kym game loop frontu neuvolni (Session.parked), ziadny prikaz sa nezahodi.
+ */
+#define INPUT_QUEUE_CAP 256     // mocnina 2
+
+typedef enum {
+    IN_MOVE,
+    IN_PAUSE,
+    IN_RESUME,
+    IN_QUIT
+} InputType;
+
+typedef struct {
+    long long t_ns;     // kedy prikaz prisiel (CLOCK_MONOTONIC)
+    InputType type;
+    char dir;           // smer pri IN_MOVE
+    unsigned seq;       // poradove cislo MOVE od klienta (0 = bez seq)
+} InputCmd;
+
+typedef struct {
+    InputCmd cmds[INPUT_QUEUE_CAP];
+    _Alignas(64) atomic_uint head;  // dalsi na citanie (meni len citatel)
+    _Alignas(64) atomic_uint tail;  // dalsi volny (meni len zapisovatel)
+    atomic_ulong full;              // kolkokrat bola fronta plna (zapisovatel cakal)
+} InputQueue;
+
+void input_queue_init(InputQueue* q);
+
+// Zapisovatel: vrati 1, alebo 0 ak je fronta plna (prikaz treba skusit neskor)
+int input_push(InputQueue* q, const InputCmd* c);
+
+// Citatel: vrati 1 a najstarsi prikaz v c, alebo 0 ak je fronta prazdna
+int input_pop(InputQueue* q, InputCmd* c);
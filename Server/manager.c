@@ -0,0 +1,618 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+
+#include "../Common/protocol.h"
+#include "manager.h"
+#include "session.h"
+#include "broadcast.h"
+#include "ticker.h"
+
+#define MAX_EVENTS 64
+
+// kolko tickov po GAME_OVER sa este skusa doposlat fronta, potom sa spojenie zavrie
+#define LINGER_TICKS 20
+
+/*
+ * Jedna hra v tabulke: session + jej vlastny GameState.
+ * V arene session pouziva spolocny GameState loopu a vlastny g ostava nepouzity.
+ * bot = synteticka hra bez klienta (nahodne pohyby, ramce sa neposielaju).
+ * Divak (WATCH) nema hru, dostava zdielane ramce areny cez w.
+ */
+typedef struct {
+    Session s;
+    GameState g;
+    int bot;
+    int arena_bot;      // bot hra v arene loopu
+    int linger;         // po GAME_OVER: zostavajuce ticky na doposlanie fronty
+    int read_paused;    // plna fronta prikazov: socket sa necita (vypnute EPOLLIN)
+    Watcher w;
+} Slot;
+
+typedef struct Loop {
+    int id;
+    pthread_t th;
+    int epfd;
+    int listen_fd;
+    const ManagerOpts* opts;
+    Ticker ticker;          // terminy tickov (timerfd v epoll)
+    int timer_fd;
+
+    Slot** slots;
+    int count;
+    int cap;
+
+    /*
+     * Arena a divaci su len v jednom loope (arena_loop = loop 0), aby sa
+     * hraci a divaci z roznych loopov videli. START ... ARENA a WATCH
+     * v inom loope presunu slot sem cez frontu moved (zobudi ju moved_fd).
+     */
+    struct Loop* arena_loop;
+    GameState arena;        // vytvori ju prvy START ... ARENA, zanikne bez hracov
+    pthread_mutex_t moved_mtx;
+    Slot** moved;
+    int moved_len;
+    int moved_cap;
+    int moved_fd;           // eventfd v epoll arena loopu, -1 v ostatnych
+
+    /* divaci areny: jeden stream (ramec za tick) na format */
+    Broadcast watch[FRAME_FORMATS];
+    int watchers;
+
+    char out[FRAME_CAP];
+    GameRng rng;            // nahodne pohyby botov (bez zdielaneho rand())
+
+    /* statistika za aktualny interval */
+    long long busy_ns;
+    long long busy_max_ns;
+    long ticks;
+    long long bytes;
+    long coalesced;         // ticky bez ramca pre pomalych hracov (zlucene do dalsieho)
+    long watch_frames;      // ramce odoslane divakom
+    long watch_drops;       // ramce zahodene pomalym divakom
+} Loop;
+
+/* Arenu vidi len arena loop, ostatne loopy START ... ARENA / WATCH odlozia */
+static void set_arena(Loop* L, Session* s) {
+    s->arena = (L == L->arena_loop) ? &L->arena : NULL;
+    s->arena_remote = (L != L->arena_loop);
+}
+
+static Slot* slot_add(Loop* L, int fd, int bot) {
+    Slot* sl = calloc(1, sizeof(*sl));
+    if (!sl) return NULL;
+
+    if (L->count == L->cap) {
+        int ncap = L->cap ? L->cap * 2 : 64;
+        Slot** ns = realloc(L->slots, (size_t)ncap * sizeof(*ns));
+        if (!ns) { free(sl); return NULL; }
+        L->slots = ns;
+        L->cap = ncap;
+    }
+
+    session_init(&sl->s, fd, &sl->g);
+    set_arena(L, &sl->s);
+    sl->s.max_rows = L->opts->max_rows;
+    sl->s.max_cols = L->opts->max_cols;
+    sl->bot = bot;
+    L->slots[L->count++] = sl;
+    return sl;
+}
+
+/* Odstrani slot na indexe i (swap-remove) */
+static void slot_remove(Loop* L, int i) {
+    Slot* sl = L->slots[i];
+
+    if (!sl->bot) {
+        close(sl->s.client_fd);
+        if (sl->s.out.coalesced > 0) {
+            printf("Client disconnected (frames=%ld coalesced=%ld)\n",
+                   sl->s.out.frames, sl->s.out.coalesced);
+        }
+        else {
+            printf("Client disconnected\n");
+        }
+    }
+    if (sl->s.watching) {
+        watcher_release(&sl->w);
+    }
+    else if (sl->s.shared) {
+        pthread_mutex_lock(&L->arena.mtx);
+        game_leave(&L->arena, sl->s.player);
+        pthread_mutex_unlock(&L->arena.mtx);
+    }
+    else if (sl->s.game_started) {
+        game_destroy(&sl->g);
+    }
+    free(sl);
+
+    L->slots[i] = L->slots[--L->count];
+}
+
+/*
+ * Synteticka hra: posle START ako skutocny klient.
+ * Velkosti sa striedaju, aby v jednom procese bezali hry roznych rozmerov.
+ */
+static void bot_start(Loop* L, Slot* sl, int variant) {
+    static const char* starts[] = {
+        CMD_START " 20 40 WRAP OBS STANDARD",
+        CMD_START " 25 50 WALLS NOOBS STANDARD",
+        CMD_START " 30 60 WRAP OBS STANDARD",
+    };
+
+    session_init(&sl->s, -1, &sl->g);
+    set_arena(L, &sl->s);
+    if (sl->arena_bot) session_handle_command(&sl->s, CMD_START " 30 60 WRAP OBS STANDARD " START_ARENA);
+    else session_handle_command(&sl->s, starts[variant % 3]);
+}
+
+static void bot_move(Loop* L, Slot* sl) {
+    static const char dirs[] = "wasd";
+    char cmd[16];
+
+    if (rng_below(&L->rng, 4) != 0) return;
+    snprintf(cmd, sizeof(cmd), "%s %c", CMD_MOVE, dirs[rng_below(&L->rng, 4)]);
+    session_handle_command(&sl->s, cmd);
+}
+
+static void accept_clients(Loop* L) {
+    while (1) {
+        int fd = accept(L->listen_fd, NULL, NULL);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            break; /* EAGAIN - vsetci prijati */
+        }
+
+        /* neblokujuci socket: plny buffer klienta nezdrzi loop (session_flush) */
+        fcntl(fd, F_SETFL, O_NONBLOCK);
+
+        Slot* sl = slot_add(L, fd, 0);
+        if (!sl) { close(fd); continue; }
+
+        struct epoll_event ev = { .events = EPOLLIN, .data.ptr = sl };
+        if (epoll_ctl(L->epfd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+            perror("epoll_ctl");
+            slot_remove(L, L->count - 1);
+            continue;
+        }
+        printf("Client connected\n");
+    }
+}
+
+/* Citanie klienta pozastavene/obnovene (plna fronta prikazov) */
+static void set_reading(Loop* L, Slot* sl, int on) {
+    struct epoll_event ev = { .events = on ? EPOLLIN : 0, .data.ptr = sl };
+    epoll_ctl(L->epfd, EPOLL_CTL_MOD, sl->s.client_fd, &ev);
+    sl->read_paused = !on;
+}
+
+/*
+ * START ... ARENA alebo WATCH v inom loope nez arena: slot sa vyberie
+ * z tohto loopu (socket ostava otvoreny) a prevezme ho arena loop.
+ */
+static void move_slot(Loop* L, Slot* sl) {
+    Loop* A = L->arena_loop;
+    uint64_t one = 1;
+
+    epoll_ctl(L->epfd, EPOLL_CTL_DEL, sl->s.client_fd, NULL);
+
+    pthread_mutex_lock(&A->moved_mtx);
+    if (A->moved_len == A->moved_cap) {
+        int ncap = A->moved_cap ? A->moved_cap * 2 : 16;
+        Slot** nm = realloc(A->moved, (size_t)ncap * sizeof(*nm));
+        if (!nm) {
+            pthread_mutex_unlock(&A->moved_mtx);
+            /* slot ostava tu, zavrie ho najblizsi tick */
+            sl->s.client_disconnected = 1;
+            return;
+        }
+        A->moved = nm;
+        A->moved_cap = ncap;
+    }
+    A->moved[A->moved_len++] = sl;
+    pthread_mutex_unlock(&A->moved_mtx);
+
+    for (int i = 0; i < L->count; i++) {
+        if (L->slots[i] == sl) {
+            L->slots[i] = L->slots[--L->count];
+            break;
+        }
+    }
+
+    if (write(A->moved_fd, &one, sizeof(one)) < 0) perror("write moved_fd");
+}
+
+/* Arena loop prevezme presunute sloty a zopakuje im odlozeny prikaz */
+static void take_moved(Loop* L) {
+    uint64_t n;
+    if (read(L->moved_fd, &n, sizeof(n)) < 0) return;
+
+    pthread_mutex_lock(&L->moved_mtx);
+    for (int i = 0; i < L->moved_len; i++) {
+        Slot* sl = L->moved[i];
+        char cmd[CMD_LINE_MAX];
+
+        if (L->count == L->cap) {
+            int ncap = L->cap ? L->cap * 2 : 64;
+            Slot** ns = realloc(L->slots, (size_t)ncap * sizeof(*ns));
+            if (!ns) {
+                /* bez miesta v tabulke: spojenie zavrieme */
+                close(sl->s.client_fd);
+                free(sl);
+                continue;
+            }
+            L->slots = ns;
+            L->cap = ncap;
+        }
+        L->slots[L->count++] = sl;
+
+        struct epoll_event ev = { .events = sl->read_paused ? 0 : EPOLLIN, .data.ptr = sl };
+        if (epoll_ctl(L->epfd, EPOLL_CTL_ADD, sl->s.client_fd, &ev) < 0) {
+            perror("epoll_ctl");
+            sl->s.client_disconnected = 1;
+        }
+
+        set_arena(L, &sl->s);
+        snprintf(cmd, sizeof(cmd), "%s", sl->s.handoff);
+        sl->s.handoff[0] = '\0';
+        session_handle_command(&sl->s, cmd);
+    }
+    L->moved_len = 0;
+    pthread_mutex_unlock(&L->moved_mtx);
+}
+
+static void read_client(Loop* L, Slot* sl) {
+    char buf[FEED_MAX];
+
+    /* precitame vsetko, co prislo (aj viac prikazov v jednom segmente) */
+    while (1) {
+        int r = (int)recv(sl->s.client_fd, buf, sizeof(buf), MSG_DONTWAIT);
+
+        if (r < 0 && errno == EINTR) continue;
+        if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+
+        /* Odpojenie klienta neukonci hru, hra dobehne (timeout v session_tick) */
+        if (r <= 0) {
+            sl->s.client_disconnected = 1;
+            epoll_ctl(L->epfd, EPOLL_CTL_DEL, sl->s.client_fd, NULL);
+            return;
+        }
+
+        session_feed(&sl->s, buf, r);
+
+        /* arena je v inom loope: dalej slot cita a krokuje on */
+        if (sl->s.handoff[0]) {
+            move_slot(L, sl);
+            return;
+        }
+
+        /* plna fronta: dalsie prikazy nechame v sockete, kym ich tick neprevezme */
+        if (sl->s.parked_len > 0) {
+            set_reading(L, sl, 0);
+            break;
+        }
+        if (r < (int)sizeof(buf)) break;
+    }
+}
+
+/*
+ * Divaci areny: ramec sa pre kazdy format zakoduje raz, vsetci divaci
+ * dostanu referenciu na ten isty buffer. Divaci bez keyframe dostanu
+ * spolocny keyframe, ostatni deltu. Posiela sa neblokujuco.
+ */
+static void watch_tick(Loop* L) {
+    SharedFrame* frames[FRAME_FORMATS] = { NULL };
+    SharedFrame* keys[FRAME_FORMATS] = { NULL };
+
+    for (int f = 0; f < FRAME_FORMATS; f++) {
+        L->watch[f].watchers = 0;
+        L->watch[f].resync = 0;
+    }
+    L->watchers = 0;
+    for (int i = 0; i < L->count; i++) {
+        Slot* sl = L->slots[i];
+        if (!sl->s.watching) continue;
+
+        Broadcast* b = &L->watch[sl->s.frames.format];
+        b->watchers++;
+        if (!sl->w.synced) b->resync = 1;
+        L->watchers++;
+    }
+    if (L->watchers == 0) return;
+
+    /* bez areny nie je co vysielat, nova arena zacne keyframe */
+    if (!L->arena.players) {
+        for (int f = 0; f < FRAME_FORMATS; f++) broadcast_init(&L->watch[f], (FrameFormat)f);
+        return;
+    }
+
+    pthread_mutex_lock(&L->arena.mtx);
+    for (int f = 0; f < FRAME_FORMATS; f++) {
+        if (L->watch[f].watchers == 0) continue;
+        frames[f] = broadcast_build(&L->watch[f], &L->arena, L->out, (int)sizeof(L->out),
+                                    &keys[f]);
+        if (frames[f]) L->bytes += frames[f]->len;
+        if (keys[f]) L->bytes += keys[f]->len;
+    }
+    pthread_mutex_unlock(&L->arena.mtx);
+
+    for (int i = L->count - 1; i >= 0; i--) {
+        Slot* sl = L->slots[i];
+        Session* s = &sl->s;
+        if (!s->watching) continue;
+
+        SharedFrame* fr = frames[s->frames.format];
+        if (!sl->w.synced && keys[s->frames.format]) fr = keys[s->frames.format];
+        long sent = sl->w.frames, drops = sl->w.drops;
+        int err = !s->client_disconnected && s->state != STATE_GAMEOVER && fr &&
+                  watcher_offer(&sl->w, s->client_fd, fr) < 0;
+
+        L->watch_frames += sl->w.frames - sent;
+        L->watch_drops += sl->w.drops - drops;
+        if (err || s->client_disconnected || s->state == STATE_GAMEOVER) slot_remove(L, i);
+    }
+
+    /* kazdy divak si drzi vlastnu referenciu */
+    for (int f = 0; f < FRAME_FORMATS; f++) {
+        shared_frame_unref(frames[f]);
+        shared_frame_unref(keys[f]);
+    }
+}
+
+/* Jeden tick vsetkych hier v loope */
+static void tick_all(Loop* L) {
+    /* arena sa krokuje raz za tick pre vsetkych hracov naraz */
+    if (L->arena.players) {
+        if (L->arena.active_players == 0) {
+            game_destroy(&L->arena);
+            memset(&L->arena, 0, sizeof(L->arena));
+        }
+        else {
+            /* prikazy vsetkych hracov areny, potom jeden krok */
+            pthread_mutex_lock(&L->arena.mtx);
+            for (int i = 0; i < L->count; i++) {
+                if (L->slots[i]->s.shared) session_apply_input(&L->slots[i]->s);
+            }
+            game_step(&L->arena);
+            pthread_mutex_unlock(&L->arena.mtx);
+        }
+    }
+    watch_tick(L);
+
+    for (int i = L->count - 1; i >= 0; i--) {
+        Slot* sl = L->slots[i];
+        Session* s = &sl->s;
+
+        if (s->watching) continue;
+        if (!s->game_started) {
+            /* odisiel pred START alebo plna arena */
+            if (s->client_disconnected || s->state == STATE_GAMEOVER) slot_remove(L, i);
+            continue;
+        }
+
+        /* hra skoncila, klient este preberal ramce: doposleme GAME_OVER */
+        if (sl->linger > 0) {
+            if (session_flush(s) != 0 || --sl->linger == 0) {
+                shutdown(s->client_fd, SHUT_RDWR);
+                slot_remove(L, i);
+            }
+            continue;
+        }
+
+        if (sl->bot) bot_move(L, sl);
+
+        long coalesced = s->out.coalesced;
+        L->bytes += session_tick(s);
+        L->coalesced += s->out.coalesced - coalesced;
+
+        if (session_flush(s) < 0) s->client_disconnected = 1;
+
+        /* tick prevzal prikazy: odlozene do fronty a citat dalej */
+        if (sl->read_paused && !s->client_disconnected && session_push_parked(s) == 0) {
+            set_reading(L, sl, 1);
+        }
+
+        if (s->state == STATE_GAMEOVER) {
+            if (sl->bot) {
+                if (s->shared) {
+                    pthread_mutex_lock(&L->arena.mtx);
+                    game_leave(&L->arena, s->player);
+                    pthread_mutex_unlock(&L->arena.mtx);
+                }
+                else {
+                    game_destroy(&sl->g);
+                    memset(&sl->g, 0, sizeof(sl->g));
+                }
+                bot_start(L, sl, (int)rng_below(&L->rng, 3));
+            }
+            else if (session_pending(s) && !s->client_disconnected) {
+                sl->linger = LINGER_TICKS;
+            }
+            else {
+                shutdown(s->client_fd, SHUT_RDWR);
+                slot_remove(L, i);
+            }
+        }
+    }
+}
+
+static void print_stats(Loop* L, double interval_sec) {
+    if (L->ticks == 0) return;
+
+    double avg_ms = (double)L->busy_ns / L->ticks / 1e6;
+    double max_ms = (double)L->busy_max_ns / 1e6;
+    double load = avg_ms / L->opts->tick_ms * 100.0;
+
+    /* odhad: kolko hier s rovnakou zatazou sa zmesti do jednej periody ticku */
+    int capacity = avg_ms > 0.0 ? (int)(L->count * L->opts->tick_ms / avg_ms) : 0;
+
+    printf("[loop %d] sessions=%d tick avg=%.3f ms max=%.3f ms load=%.1f%% "
+           "out=%.1f KB/s capacity~%d sessions/core\n",
+           L->id, L->count, avg_ms, max_ms, load,
+           L->bytes / 1024.0 / interval_sec, capacity);
+    if (L->coalesced > 0) {
+        printf("[loop %d] slow clients: %ld ticks coalesced into later frames\n",
+               L->id, L->coalesced);
+    }
+    if (L->watchers > 0 || L->watch_drops > 0) {
+        printf("[loop %d] watchers=%d frames sent=%ld dropped=%ld\n",
+               L->id, L->watchers, L->watch_frames, L->watch_drops);
+    }
+
+    char label[32];
+    snprintf(label, sizeof(label), "[loop %d]", L->id);
+    ticker_report(&L->ticker, label);
+
+    L->busy_ns = 0;
+    L->busy_max_ns = 0;
+    L->ticks = 0;
+    L->bytes = 0;
+    L->coalesced = 0;
+    L->watch_frames = 0;
+    L->watch_drops = 0;
+}
+
+static int loop_setup(Loop* L, int id, int server_fd, const ManagerOpts* opts, Loop* arena_loop) {
+    memset(L, 0, sizeof(*L));
+    L->id = id;
+    L->listen_fd = server_fd;
+    L->opts = opts;
+    L->arena_loop = arena_loop;
+    L->moved_fd = -1;
+    pthread_mutex_init(&L->moved_mtx, NULL);
+    rng_seed(&L->rng, (uint64_t)time(NULL), (uint64_t)id);
+    for (int f = 0; f < FRAME_FORMATS; f++) broadcast_init(&L->watch[f], (FrameFormat)f);
+
+    L->epfd = epoll_create1(0);
+    if (L->epfd < 0) { perror("epoll_create1"); return -1; }
+
+    /* EPOLLEXCLUSIVE: novy klient zobudi len jeden loop, ten si ho prijme */
+    struct epoll_event lev = { .events = EPOLLIN | EPOLLEXCLUSIVE, .data.ptr = NULL };
+    if (epoll_ctl(L->epfd, EPOLL_CTL_ADD, server_fd, &lev) < 0) {
+        perror("epoll_ctl"); return -1;
+    }
+
+    /* tick = timerfd s absolutnymi terminmi, epoll_wait uz nepocita timeout */
+    ticker_init(&L->ticker, opts->tick_ms);
+    L->timer_fd = ticker_timerfd(&L->ticker);
+    if (L->timer_fd < 0) return -1;
+
+    struct epoll_event tev = { .events = EPOLLIN, .data.ptr = &L->ticker };
+    if (epoll_ctl(L->epfd, EPOLL_CTL_ADD, L->timer_fd, &tev) < 0) {
+        perror("epoll_ctl"); return -1;
+    }
+
+    if (L != arena_loop) return 0;
+
+    /* presunute sloty z ostatnych loopov (move_slot) */
+    L->moved_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (L->moved_fd < 0) { perror("eventfd"); return -1; }
+
+    struct epoll_event mev = { .events = EPOLLIN, .data.ptr = &L->moved_fd };
+    if (epoll_ctl(L->epfd, EPOLL_CTL_ADD, L->moved_fd, &mev) < 0) {
+        perror("epoll_ctl"); return -1;
+    }
+    return 0;
+}
+
+static void* loop_run(void* arg) {
+    Loop* L = (Loop*)arg;
+    const ManagerOpts* opts = L->opts;
+
+    long long next_stats = ticker_now_ns() + (long long)opts->stats_interval_sec * 1000000000LL;
+    struct epoll_event evs[MAX_EVENTS];
+
+    while (1) {
+        int n = epoll_wait(L->epfd, evs, MAX_EVENTS, -1);
+        if (n < 0 && errno != EINTR) { perror("epoll_wait"); break; }
+
+        int tick = 0;
+        for (int i = 0; i < n; i++) {
+            if (evs[i].data.ptr == NULL) accept_clients(L);
+            else if (evs[i].data.ptr == &L->ticker) {
+                uint64_t expirations;
+                if (read(L->timer_fd, &expirations, sizeof(expirations)) > 0) tick = 1;
+            }
+            else if (evs[i].data.ptr == &L->moved_fd) take_moved(L);
+            else read_client(L, (Slot*)evs[i].data.ptr);
+        }
+
+        if (!tick) continue;
+
+        /* jitter a vynechane terminy (zmeskane ticky sa nedobiehaju) */
+        ticker_fired(&L->ticker);
+
+        long long now = ticker_now_ns();
+        tick_all(L);
+
+        long long done = ticker_now_ns();
+        long long busy = done - now;
+        L->busy_ns += busy;
+        if (busy > L->busy_max_ns) L->busy_max_ns = busy;
+        L->ticks++;
+
+        if (opts->stats_interval_sec > 0 && done >= next_stats) {
+            print_stats(L, opts->stats_interval_sec);
+            next_stats = done + (long long)opts->stats_interval_sec * 1000000000LL;
+        }
+    }
+
+    for (int i = L->count - 1; i >= 0; i--) slot_remove(L, i);
+    free(L->slots);
+    for (int i = 0; i < L->moved_len; i++) {
+        close(L->moved[i]->s.client_fd);
+        free(L->moved[i]);
+    }
+    free(L->moved);
+    if (L->arena.players) game_destroy(&L->arena);
+    if (L->moved_fd >= 0) close(L->moved_fd);
+    close(L->timer_fd);
+    close(L->epfd);
+    return NULL;
+}
+
+int manager_run(int server_fd, const ManagerOpts* opts) {
+    int nloops = opts->workers > 0 ? opts->workers : 1;
+    Loop* loops = calloc((size_t)nloops, sizeof(*loops));
+    if (!loops) return 1;
+
+    fcntl(server_fd, F_SETFL, O_NONBLOCK);
+
+    for (int i = 0; i < nloops; i++) {
+        if (loop_setup(&loops[i], i, server_fd, opts, &loops[0]) < 0) return 1;
+    }
+
+    /* synteticke hry rozdelime rovnomerne medzi loopy */
+    for (int i = 0; i < opts->bots; i++) {
+        Slot* sl = slot_add(&loops[i % nloops], -1, 1);
+        if (sl) bot_start(&loops[i % nloops], sl, i);
+    }
+    /* arena je len v loope 0 */
+    for (int i = 0; i < opts->arena_bots; i++) {
+        Slot* sl = slot_add(&loops[0], -1, 1);
+        if (!sl) continue;
+        sl->arena_bot = 1;
+        bot_start(&loops[0], sl, i);
+    }
+
+    /* loop 0 bezi v hlavnom vlakne, ostatne vo vlastnych */
+    for (int i = 1; i < nloops; i++) {
+        pthread_create(&loops[i].th, NULL, loop_run, &loops[i]);
+    }
+    loop_run(&loops[0]);
+
+    for (int i = 1; i < nloops; i++) {
+        pthread_join(loops[i].th, NULL);
+    }
+    free(loops);
+    return 0;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+/*
+ * Epoll manager: jeden proces hostuje vela nezavislych hier.
+ * Prijima klientov bez prestania, kazdy ma vlastnu Session a GameState
+ * a hry sa krokuju z maleho poctu event loopov (jeden loop = jedno vlakno).
+ * Arena (START ... ARENA: viac hracov na jednej mape) a jej divaci (WATCH)
+ * su vzdy v loope 0, spojenia z ostatnych loopov sa tam presunu.
+ */
+typedef struct {
+    int workers;            // pocet event loopov
+    int tick_ms;            // perioda ticku (default 150 ms, -t)
+    int bots;               // pocet syntetickych hier bez klienta (meranie kapacity)
+    int arena_bots;         // pocet syntetickych hracov v arene (loop 0)
+    int stats_interval_sec; // ako casto vypisat statistiku loopu (0 = nikdy)
+    int max_rows, max_cols; // najvacsia mapa v START (-M), vacsia sa odmietne
+} ManagerOpts;
+
+/* Bezi az do ukoncenia procesu */
+int manager_run(int server_fd, const ManagerOpts* opts);
@@ -0,0 +1,87 @@
+/*
+ * Replay zaznamov hier (server -r DIR): hru odsimuluje headless cez game_step
+ * tak rychlo, ako vladze CPU, a porovna koniec so zaznamom (spory o vysledok).
+ * S -n N prehra kazdy zaznam N-krat (benchmark enginu na skutocnej hre).
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <time.h>
+
+#include "gamelog.h"
+
+static long long now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr,
+        "Pouzitie: %s [-n N] ZAZNAM...\n"
+        "  -n N   kazdy zaznam prehrat N-krat (meranie rychlosti, default 1)\n",
+        prog);
+}
+
+int main(int argc, char** argv) {
+    int repeat = 1;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:h")) != -1) {
+        switch (opt) {
+        case 'n': repeat = atoi(optarg); break;
+        default: usage(argv[0]); return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (optind >= argc) { usage(argv[0]); return 1; }
+    if (repeat < 1) repeat = 1;
+
+    static GameState g;
+    int bad = 0;
+    long long all_ticks = 0, all_ns = 0, all_game_ms = 0;
+
+    for (int a = optind; a < argc; a++) {
+        GameLog log;
+        if (gamelog_load(&log, argv[a]) < 0) { bad = 1; continue; }
+
+        const GameLogHeader* h = &log.h;
+        ReplayResult r;
+        int match = 0;
+
+        long long t0 = now_ns();
+        for (int k = 0; k < repeat; k++) match = gamelog_replay(&log, &g, &r);
+        long long ns = now_ns() - t0;
+
+        long long ticks = (long long)r.ticks * repeat;
+        long long game_ms = ticks * h->tick_ms;
+        all_ticks += ticks;
+        all_ns += ns;
+        all_game_ms += game_ms;
+
+        printf("%s: %dx%d %s %s%s seed=%u, %d prikazov, %u tickov\n", argv[a],
+               h->rows, h->cols, h->world == WORLD_WALLS ? "WALLS" : "WRAP",
+               h->mode == MODE_TIMED ? "TIMED" : "STANDARD", h->obstacle_pct ? " OBS" : "",
+               h->seed, log.ncmds, r.ticks);
+        if (match < 0) {
+            printf("  zaznam bez konca, po poslednom prikaze: skore %d, dlzka %d\n", r.score, r.len);
+        }
+        else {
+            printf("  skore %d (zaznam %d), dlzka %d (%d), tick %u (%u): %s\n",
+                   r.score, log.end.score, r.len, log.end.len, r.ticks, log.end.tick,
+                   match ? "ZHODA" : "NEZHODA");
+            if (!match) bad = 1;
+        }
+        printf("  %.1f ns/tick, %.0fx rychlejsie ako realny cas (tick %d ms)\n",
+               ticks ? (double)ns / ticks : 0.0, ns ? game_ms * 1e6 / ns : 0.0, h->tick_ms);
+
+        gamelog_free(&log);
+    }
+
+    if (argc - optind > 1 && all_ns > 0) {
+        printf("spolu: %lld tickov, %.1f ns/tick, %.0fx rychlejsie ako realny cas\n",
+               all_ticks, (double)all_ns / all_ticks, all_game_ms * 1e6 / all_ns);
+    }
+    return bad;
+}
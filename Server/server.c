@@ -3,47 +3,38 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <errno.h>
 #include <unistd.h>
 #include <arpa/inet.h>
 #include <pthread.h>
 #include <fcntl.h>
+#include <stdint.h>
+#include <sys/eventfd.h>
 
 #include "../Common/protocol.h"
 #include "game.h"
+#include "session.h"
+#include "manager.h"
+#include "ticker.h"
 
-/* Stavovy protokol */
-typedef enum {
-    STATE_WAITING,
-    STATE_RUNNING,
-    STATE_PAUSED,
-    STATE_GAMEOVER
-} ServerState;
-
-/*
- * Context pre receive thread
- */
-typedef struct {
-    int client_fd;
-    GameState* g;
-    volatile ServerState state;
-    WorldType world;
-    GameMode game_mode;
-    int time_limit;
-    int map_rows;
-    int map_cols;
-    int has_obstacles;
-    volatile int client_disconnected;
-} ClientCtx;
+static void sleep_us(long us)
+{
+    struct timespec ts;
+    ts.tv_sec = us / 1000000;
+    ts.tv_nsec = (us % 1000000) * 1000;
+    nanosleep(&ts, NULL);
+}
 
 /*
  * RECEIVE THREAD
+ * Hru nezamyka: START inicializuje hru, herne prikazy idu do ctx->input.
  */
 static void* recv_loop(void* arg) {
-    ClientCtx* ctx = (ClientCtx*)arg;
-    char buf[256];
+    Session* ctx = (Session*)arg;
+    char buf[FEED_MAX];
 
     while (1) {
-        int r = (int)recv(ctx->client_fd, buf, sizeof(buf) - 1, 0);
+        int r = (int)recv(ctx->client_fd, buf, sizeof(buf), 0);
         
         /* 
          * Odpojenie klienta neukonci hru na serveri, hra pokracuje
@@ -53,91 +44,30 @@ static void* recv_loop(void* arg) {
             break;
         }
 
-        buf[r] = '\0';
-
-        /* START - len v stave WAITING */
-        /* Format: START <rows> <cols> <WALLS/WRAP> <OBS/NOOBS> <mode> [time] */
-        if (strncmp(buf, CMD_START " ", strlen(CMD_START) + 1) == 0) {
-            if (ctx->state != STATE_WAITING) continue;
-            
-            char world_str[32], mode_str[32], obs_str[32];
-            int rows = 20, cols = 40;
-            int time_limit = 0;
-            int parsed = sscanf(buf + strlen(CMD_START) + 1, "%d %d %s %s %s %d", 
-                               &rows, &cols, world_str, obs_str, mode_str, &time_limit);
-            
-            if (parsed >= 5) {
-                ctx->map_rows = rows;
-                ctx->map_cols = cols;
-                ctx->world = (strncmp(world_str, "WALLS", 5) == 0) ? WORLD_WALLS : WORLD_WRAP;
-                ctx->has_obstacles = (strncmp(obs_str, "OBS", 3) == 0) ? 1 : 0;
-                
-                if (strncmp(mode_str, "STANDARD", 8) == 0) {
-                    ctx->game_mode = MODE_STANDARD;
-                    ctx->time_limit = 0;
-                } else {
-                    ctx->game_mode = MODE_TIMED;
-                    ctx->time_limit = (parsed >= 6) ? time_limit : 60;
-                }
-                ctx->state = STATE_RUNNING;
-            }
-        }
-        /* MOVE - len v stave RUNNING */
-        else if (strncmp(buf, CMD_MOVE " ", strlen(CMD_MOVE) + 1) == 0) {
-            if (ctx->state != STATE_RUNNING) continue;
-            
-            char dir = buf[strlen(CMD_MOVE) + 1];
-            pthread_mutex_lock(&ctx->g->mtx);
-            game_set_dir(ctx->g, dir);
-            pthread_mutex_unlock(&ctx->g->mtx);
-        }
-        /* PAUSE */
-        else if (strncmp(buf, CMD_PAUSE, strlen(CMD_PAUSE)) == 0) {
-            if (ctx->state != STATE_RUNNING) continue;
-            
-            pthread_mutex_lock(&ctx->g->mtx);
-            if (!ctx->g->paused) {
-                ctx->g->paused = 1;
-                ctx->g->pause_start = time(NULL);
-                ctx->state = STATE_PAUSED;
-            }
-            pthread_mutex_unlock(&ctx->g->mtx);
-        }
-        /* RESUME */
-        else if (strncmp(buf, CMD_RESUME, strlen(CMD_RESUME)) == 0) {
-            if (ctx->state != STATE_PAUSED) continue;
-            
-            pthread_mutex_lock(&ctx->g->mtx);
-            if (ctx->g->paused) {
-                ctx->g->paused = 0;
-                ctx->g->total_pause_time += (int)(time(NULL) - ctx->g->pause_start);
-                ctx->state = STATE_RUNNING;
+        /* vsetky kompletne prikazy z tohto recv naraz */
+        session_feed(ctx, buf, r);
+
+        /*
+         * Plna fronta: socket necitame, kym game loop prikazy neprevezme
+         * (TCP pribrzdi klienta). Tick po prevzati zapise do room_fd, koniec
+         * hry tiez - vtedy uz odlozene prikazy nikto neprevezme.
+         */
+        while (session_push_parked(ctx) > 0 && ctx->state != STATE_GAMEOVER) {
+            uint64_t n;
+            if (read(ctx->room_fd, &n, sizeof(n)) < 0 && errno != EINTR) {
+                perror("read room_fd");
+                break;
             }
-            pthread_mutex_unlock(&ctx->g->mtx);
-        }
-        /* QUIT */
-        else if (strncmp(buf, CMD_QUIT, strlen(CMD_QUIT)) == 0) {
-            pthread_mutex_lock(&ctx->g->mtx);
-            ctx->g->running = 0;
-            pthread_mutex_unlock(&ctx->g->mtx);
         }
     }
 
     return NULL;
 }
 
-static void sleep_us(long us)
-{
-    struct timespec ts;
-    ts.tv_sec = us / 1000000;
-    ts.tv_nsec = (us % 1000000) * 1000;
-    nanosleep(&ts, NULL);
-}
-
 /*
 * Vytvori server socket
 */
-static int start_server(void) {
+static int start_server(int backlog) {
     int fd = socket(AF_INET, SOCK_STREAM, 0);
     if (fd < 0) { perror("socket"); exit(1); }
 
@@ -152,19 +82,19 @@ static int start_server(void) {
     if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
         perror("bind"); exit(1);
     }
-    if (listen(fd, 1) < 0) {
+    if (listen(fd, backlog) < 0) {
         perror("listen"); exit(1);
     }
 
     return fd;
 }
 
-int main(void) {
-    /* aby sa printf zobrazovali hned aj pri spustani cez iny proces */
-    setvbuf(stdout, NULL, _IONBF, 0);
-
-    int server_fd = start_server();
-    printf("Server listening on port %d\n", SERVER_PORT);
+/*
+ * Klasicky rezim: jeden klient, jedna hra, po skonceni hry server zanikne.
+ * (takto ho spusta lokalny klient)
+ */
+static int run_single(int server_fd, const ManagerOpts* opts, const char* record_dir) {
+    int tick_ms = opts->tick_ms;
 
     /* Non-blocking accept */
     fcntl(server_fd, F_SETFL, O_NONBLOCK);
@@ -181,24 +111,24 @@ int main(void) {
 
         printf("Client connected\n");
 
-        char out[8192];
         GameState g;
         memset(&g, 0, sizeof(g));  // Inicializuj na 0
 
-        ClientCtx ctx = {
-            .client_fd = client_fd,
-            .g = &g,
-            .state = STATE_WAITING,
-            .world = WORLD_WRAP,
-            .client_disconnected = 0
-        };
+        Session ctx;
+        session_init(&ctx, client_fd, &g);
+        ctx.record_dir = record_dir;
+        ctx.tick_ms = tick_ms;
+        ctx.max_rows = opts->max_rows;
+        ctx.max_cols = opts->max_cols;
+        ctx.room_fd = eventfd(0, EFD_CLOEXEC);
+        if (ctx.room_fd < 0) { perror("eventfd"); exit(1); }
 
         pthread_t th_recv;
         pthread_create(&th_recv, NULL, recv_loop, &ctx);
 
         /* HLAVNY LOOP (cakame na START alebo disconnect pred START) */
         while (!ctx.client_disconnected) {
-            /* Cakame na START */
+            /* Cakame na START (hru inicializuje recv thread) */
             while (ctx.state == STATE_WAITING && !ctx.client_disconnected) {
                 sleep_us(10000);
             }
@@ -207,116 +137,40 @@ int main(void) {
                 break; /* klient odisiel este pred START */
             }
 
-            printf("Starting game - World: %s, Mode: %s, Size: %dx%d, Obstacles: %s\n",
-                ctx.world == WORLD_WALLS ? "WALLS" : "WRAP",
-                ctx.game_mode == MODE_STANDARD ? "STANDARD" : "TIMED",
-                ctx.map_rows, ctx.map_cols,
-                ctx.has_obstacles ? "YES" : "NO");
-
-            game_init(&g, ctx.world, ctx.game_mode, ctx.time_limit,
-                ctx.map_rows, ctx.map_cols, ctx.has_obstacles);
+            /* GAME LOOP: pevne terminy, cas ticku a send sa nepripocitava k periode */
+            Ticker ticker;
+            ticker_init(&ticker, tick_ms);
 
             /*
-             * Aby server nebezal donekonecna bez klienta, ukonci hru po timeout-e.
+             * Socket ostava blokujuci kvoli recv threadu, send je MSG_DONTWAIT:
+             * ked klient nestiha, ramce sa zlucia (session_tick) a tick nestoji.
              */
-            time_t disconnected_at = 0;
-            const int DISCONNECT_TIMEOUT_SEC = 10;
-
-            /* GAME LOOP */
             while (ctx.state == STATE_RUNNING || ctx.state == STATE_PAUSED) {
+                session_tick(&ctx);
+                session_flush(&ctx);
+
+                if (ctx.state == STATE_GAMEOVER) break;
+
+                ticker_wait(&ticker);
+            }
 
-                /* nesposobi okamzite ukoncenie, ale korektne dobehne */
-                if (ctx.client_disconnected) {
-                    if (disconnected_at == 0) disconnected_at = time(NULL);
-                    if ((int)(time(NULL) - disconnected_at) >= DISCONNECT_TIMEOUT_SEC) {
-                        pthread_mutex_lock(&g.mtx);
-                        g.running = 0;
-                        pthread_mutex_unlock(&g.mtx);
-                    }
-                }
-                else {
-                    disconnected_at = 0;
-                }
-
-                pthread_mutex_lock(&g.mtx);
-
-                /* Kontrola casoveho limitu */
-                if (g.game_mode == MODE_TIMED && g.time_limit_sec > 0 && ctx.state == STATE_RUNNING) {
-                    time_t now = time(NULL);
-                    int elapsed = (int)(now - g.start_time) - g.total_pause_time;
-                    if (elapsed >= g.time_limit_sec) {
-                        g.running = 0;
-                        ctx.state = STATE_GAMEOVER;
-
-                        int n = snprintf(out, sizeof(out),
-                            "%s\n%s %d\nMODE TIMED\n%s 0s\n%s\n*** CAS VYPRSAL ***\nENDMAP\n",
-                            CMD_GAME_OVER, CMD_SCORE, g.score, CMD_TIME, CMD_MAP);
-
-                        pthread_mutex_unlock(&g.mtx);
-
-                        if (!ctx.client_disconnected) {
-                            send(client_fd, out, (size_t)n, 0);
-                        }
-                        break;
-                    }
-                }
-
-                /* game_step len v RUNNING */
-                if (ctx.state == STATE_RUNNING && !g.paused) {
-                    game_step(&g);
-                }
-
-                /* GAME OVER */
-                if (!g.running) {
-                    ctx.state = STATE_GAMEOVER;
-
-                    time_t now = time(NULL);
-                    int elapsed = (int)(now - g.start_time) - g.total_pause_time;
-
-                    int n = snprintf(out, sizeof(out),
-                        "%s\n%s %d\nMODE %s\n%s %ds\n%s\n*** KONIEC HRY ***\nENDMAP\n",
-                        CMD_GAME_OVER, CMD_SCORE, g.score,
-                        g.game_mode == MODE_STANDARD ? "STANDARD" : "TIMED",
-                        CMD_TIME, elapsed, CMD_MAP);
-
-                    pthread_mutex_unlock(&g.mtx);
-
-                    if (!ctx.client_disconnected) {
-                        send(client_fd, out, (size_t)n, 0);
-                    }
-                    break;
-                }
-
-                /* SCORE, MODE, TIME */
-                int n = snprintf(out, sizeof(out), "%s %d\n", CMD_SCORE, g.score);
-                n += snprintf(out + n, sizeof(out) - n, "MODE %s\n",
-                    g.game_mode == MODE_STANDARD ? "STANDARD" : "TIMED");
-
-                time_t now = time(NULL);
-                int elapsed = g.paused ?
-                    (int)(g.pause_start - g.start_time) - g.total_pause_time :
-                    (int)(now - g.start_time) - g.total_pause_time;
-
-                if (g.game_mode == MODE_TIMED) {
-                    int remaining = g.time_limit_sec - elapsed;
-                    if (remaining < 0) remaining = 0;
-                    n += snprintf(out + n, sizeof(out) - n, "%s %ds LEFT\n", CMD_TIME, remaining);
-                }
-                else {
-                    n += snprintf(out + n, sizeof(out) - n, "%s %ds\n", CMD_TIME, elapsed);
-                }
-
-                n += game_render_map(&g, out + n, (int)sizeof(out) - n);
-                pthread_mutex_unlock(&g.mtx);
-
-                if (!ctx.client_disconnected) {
-                    send(client_fd, out, (size_t)n, 0);
-                }
-
-                sleep_us(150 * 1000);
+            /* GAME_OVER doposleme, ak klient este preberal ramce (max par tickov) */
+            for (int i = 0; i < 20 && session_flush(&ctx) == 0; i++) {
+                ticker_wait(&ticker);
+            }
+            ticker_report(&ticker, "Game loop:");
+            if (ctx.applied > 0) {
+                printf("Input: commands=%lu queue full=%lu queue wait avg=%.3f ms max=%.3f ms\n",
+                       ctx.applied, (unsigned long)atomic_load(&ctx.input.full),
+                       ctx.input_wait_sum_ns / 1e6 / ctx.applied, ctx.input_wait_max_ns / 1e6);
+            }
+            if (ctx.out.coalesced > 0) {
+                printf("Slow client: frames=%ld coalesced=%ld\n", ctx.out.frames, ctx.out.coalesced);
             }
 
-            /* Po skonceni hry: ukonci spojenie, aby recv thread bezpecne skoncil */
+            /* Po skonceni hry: zobud recv thread (ak caka na frontu) a ukonci spojenie */
+            uint64_t one = 1;
+            if (write(ctx.room_fd, &one, sizeof(one)) < 0) perror("write room_fd");
             shutdown(client_fd, SHUT_RDWR);
 
             /* aby server zanikol po skonceni hry */
@@ -329,14 +183,74 @@ int main(void) {
         pthread_join(th_recv, NULL);
 
         /* Mutex destroy az po join */
-        pthread_mutex_destroy(&g.mtx);
+        if (ctx.game_started) game_destroy(&g);
+        else pthread_mutex_destroy(&g.mtx);
 
+        close(ctx.room_fd);
         close(client_fd);
         printf("Client disconnected\n");
 
         if (exit_after_game) break;
     }
 
-    close(server_fd);
     return 0;
 }
+
+static void usage(const char* prog) {
+    fprintf(stderr,
+        "Pouzitie: %s [-m] [-t MS] [-w LOOPS] [-b BOTS] [-A BOTS] [-s SEC] [-r DIR] [-M RxC]\n"
+        "  -m       multi-session server (epoll, vela hier naraz)\n"
+        "  -t MS    perioda ticku v ms (default 150)\n"
+        "  -w LOOPS pocet event loopov (vlakien) v multi-session rezime (default 1)\n"
+        "           arena (START ... ARENA) a divaci (WATCH) su vzdy v loope 0,\n"
+        "           take spojenia sa tam presunu z ostatnych loopov\n"        "  -b BOTS  pocet syntetickych hier bez klienta (meranie kapacity)\n"
+        "  -A BOTS  pocet syntetickych hracov v arene (START ... ARENA)\n"
+        "  -s SEC   interval vypisu statistiky loopu (default 5, 0 = vypnute)\n"
+        "  -r DIR   zaznam hry do DIR pre replay (klasicky rezim)\n"
+        "  -M RxC   najvacsia mapa, ktoru klient dostane (default %dx%d, najviac %dx%d)\n",
+        prog, MAP_LIMIT_DEFAULT, MAP_LIMIT_DEFAULT, MAP_DIM_MAX, MAP_DIM_MAX);
+}
+
+int main(int argc, char** argv) {
+    /* aby sa printf zobrazovali hned aj pri spustani cez iny proces */
+    setvbuf(stdout, NULL, _IONBF, 0);
+
+    int multi = 0;
+    const char* record_dir = NULL;
+    ManagerOpts mopts = { .workers = 1, .tick_ms = 150, .bots = 0, .arena_bots = 0,
+                          .stats_interval_sec = 5,
+                          .max_rows = MAP_LIMIT_DEFAULT, .max_cols = MAP_LIMIT_DEFAULT };
+
+    int opt;
+    while ((opt = getopt(argc, argv, "mt:w:b:A:s:r:M:h")) != -1) {
+        switch (opt) {
+        case 'm': multi = 1; break;
+        case 't': mopts.tick_ms = atoi(optarg); break;
+        case 'w': mopts.workers = atoi(optarg); multi = 1; break;
+        case 'b': mopts.bots = atoi(optarg); multi = 1; break;
+        case 'A': mopts.arena_bots = atoi(optarg); multi = 1; break;
+        case 's': mopts.stats_interval_sec = atoi(optarg); break;
+        case 'r': record_dir = optarg; break;
+        case 'M':
+            if (sscanf(optarg, "%dx%d", &mopts.max_rows, &mopts.max_cols) != 2 ||
+                mopts.max_rows < 5 || mopts.max_cols < 8 ||
+                mopts.max_rows > MAP_DIM_MAX || mopts.max_cols > MAP_DIM_MAX) {
+                fprintf(stderr, "-M: ocakava sa RxC od 5x8 po %dx%d\n", MAP_DIM_MAX, MAP_DIM_MAX);
+                return 1;
+            }
+            break;
+        default: usage(argv[0]); return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    int server_fd = start_server(multi ? SOMAXCONN : 1);
+    printf("Server listening on port %d%s\n", SERVER_PORT, multi ? " (multi-session)" : "");
+
+    if (mopts.tick_ms < 1) mopts.tick_ms = 1;
+    if (multi && record_dir) fprintf(stderr, "-r: zaznam hier je len v klasickom rezime\n");
+
+    int rc = multi ? manager_run(server_fd, &mopts) : run_single(server_fd, &mopts, record_dir);
+
+    close(server_fd);
+    return rc;
+}
@@ -0,0 +1,519 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include "../Common/protocol.h"
+#include "session.h"
+#include "ticker.h"
+
+/* Aby server nebezal donekonecna bez klienta, ukonci hru po timeout-e. */
+#define DISCONNECT_TIMEOUT_SEC 10
+
+void session_init(Session* s, int client_fd, GameState* g) {
+    memset(s, 0, sizeof(*s));
+    s->client_fd = client_fd;
+    s->g = g;
+    s->state = STATE_WAITING;
+    s->world = WORLD_WRAP;
+    s->max_rows = MAP_LIMIT_DEFAULT;
+    s->max_cols = MAP_LIMIT_DEFAULT;
+    frame_state_init(&s->frames, FMT_FULL);
+    input_queue_init(&s->input);
+    s->room_fd = -1;
+}
+
+/* Zaznam hry: <record_dir>/game_<datum-cas>_<seed>_<poradie>.snlog */
+static void start_record(Session* s) {
+    static atomic_uint recorded;
+    time_t now = time(NULL);
+    struct tm tm;
+    char stamp[32];
+    localtime_r(&now, &tm);
+    strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &tm);
+    snprintf(s->record_path, sizeof(s->record_path), "%s/game_%s_%u_%u.snlog",
+             s->record_dir, stamp, s->g->seed, atomic_fetch_add(&recorded, 1));
+
+    s->log = malloc(sizeof(*s->log));
+    if (!s->log) return;
+    if (gamelog_open(s->log, s->record_path, s->g, s->tick_ms) < 0) {
+        free(s->log);
+        s->log = NULL;
+    }
+}
+
+/* Koniec hry do zaznamu (stopped = ukoncil ju cas alebo odpojenie) */
+static void end_record(Session* s, int stopped) {
+    if (!s->log) return;
+    gamelog_end(s->log, (unsigned)s->ticks, stopped, s->g);
+    if (s->client_fd >= 0) printf("Game recorded: %s (%ld commands)\n", s->record_path, s->log->cmds);
+    free(s->log);
+    s->log = NULL;
+}
+
+/* START odmietnuty: ERROR klientovi (ramce este nezacali, posle sa hned) a koniec session */
+static void reject_start(Session* s, const char* why) {
+    char line[128];
+    int n = snprintf(line, sizeof(line), "%s %s\n", CMD_ERROR, why);
+
+    if (s->client_fd >= 0) {
+        printf("START rejected: %s", line + strlen(CMD_ERROR) + 1);
+        send(s->client_fd, line, (size_t)n, MSG_DONTWAIT | MSG_NOSIGNAL);
+    }
+    s->state = STATE_GAMEOVER;
+}
+
+/* Arena je v inom loope: prikaz tam zopakuje vlastnik session po presune */
+static void defer_to_arena(Session* s, const char* buf) {
+    snprintf(s->handoff, sizeof(s->handoff), "%s", buf);
+}
+
+/* Inicializuje hru podla parametrov zo START, az potom je session RUNNING */
+static void start_game(Session* s) {
+    /* synteticke hry (bez klienta) nevypisujeme */
+    if (s->client_fd >= 0) {
+        printf("Starting game - World: %s, Mode: %s, Size: %dx%d, Obstacles: %s\n",
+            s->world == WORLD_WALLS ? "WALLS" : "WRAP",
+            s->game_mode == MODE_STANDARD ? "STANDARD" : "TIMED",
+            s->map_rows, s->map_cols,
+            s->has_obstacles ? "YES" : "NO");
+    }
+
+    if (game_init(s->g, s->world, s->game_mode, s->time_limit,
+            s->map_rows, s->map_cols, s->has_obstacles ? OBSTACLE_PCT : 0) < 0) {
+        reject_start(s, "nedostatok pamate pre hru");
+        return;
+    }
+
+    if (s->record_dir) start_record(s);
+
+    s->disconnected_at = 0;
+    s->game_started = 1;
+    s->state = STATE_RUNNING;
+}
+
+/* START ... ARENA: hrac sa prida do spolocnej areny namiesto vlastnej hry */
+static void join_arena(Session* s) {
+    GameState* a = s->arena;
+
+    if (!a->players && game_init_arena(a, s->world, s->map_rows, s->map_cols,
+                                       s->has_obstacles ? OBSTACLE_PCT : 0, MAX_PLAYERS) < 0) {
+        reject_start(s, "nedostatok pamate pre arenu");
+        return;
+    }
+
+    pthread_mutex_lock(&a->mtx);
+    int p = game_join(a);
+    pthread_mutex_unlock(&a->mtx);
+
+    if (p < 0) {
+        /* arena je plna - session konci bez hry */
+        if (s->client_fd >= 0) printf("Arena full\n");
+        s->state = STATE_GAMEOVER;
+        return;
+    }
+
+    if (s->client_fd >= 0) printf("Player %d joined arena (%d players)\n", p, a->active_players);
+    s->g = a;
+    s->player = p;
+    s->frames.player = p;
+    s->shared = 1;
+    s->game_started = 1;
+    s->state = STATE_RUNNING;
+}
+
+/* Volitelny format ramcov ako posledny token (START, WATCH) */
+static void parse_format(Session* s, const char* buf) {
+    const char* last = strrchr(buf, ' ');
+    if (last && strncmp(last + 1, FRAMES_DELTA, strlen(FRAMES_DELTA)) == 0) {
+        frame_state_init(&s->frames, FMT_DELTA);
+    }
+    else if (last && strncmp(last + 1, FRAMES_BINARY, strlen(FRAMES_BINARY)) == 0) {
+        frame_state_init(&s->frames, FMT_BINARY);
+    }
+}
+
+/* Herny prikaz do fronty pre game loop (pred START sa ignoruje) */
+static void queue_input(Session* s, InputType type, char dir, unsigned seq) {
+    if (!s->game_started) return;
+
+    InputCmd c = { .t_ns = ticker_now_ns(), .type = type, .dir = dir, .seq = seq };
+    /* za odlozenymi prikazmi, aby sa nepomenilo poradie */
+    if (s->parked_len > 0 || !input_push(&s->input, &c)) {
+        /* volajuci necita socket, kym parked nie je prazdne - s FEED_MAX sa nenaplni */
+        if (s->parked_len < INPUT_PARK_CAP) s->parked[s->parked_len++] = c;
+    }
+}
+
+int session_push_parked(Session* s) {
+    int i = 0;
+    while (i < s->parked_len && input_push(&s->input, &s->parked[i])) i++;
+    if (i > 0) {
+        memmove(s->parked, s->parked + i, (size_t)(s->parked_len - i) * sizeof(s->parked[0]));
+        s->parked_len -= i;
+    }
+    return s->parked_len;
+}
+
+void session_handle_command(Session* s, const char* buf) {
+    s->commands++;
+
+    /* START - len v stave WAITING */
+    /* Format: START <rows> <cols> <WALLS/WRAP> <OBS/NOOBS> <mode> [time] [FULL/DELTA/BINARY] */
+    if (strncmp(buf, CMD_START " ", strlen(CMD_START) + 1) == 0) {
+        if (s->state != STATE_WAITING || s->handoff[0]) return;
+
+        char world_str[32], mode_str[32], obs_str[32];
+        int rows = 20, cols = 40;
+        int time_limit = 0;
+        int parsed = sscanf(buf + strlen(CMD_START) + 1, "%d %d %31s %31s %31s %d",
+                           &rows, &cols, world_str, obs_str, mode_str, &time_limit);
+
+        if (parsed >= 5 && (rows > s->max_rows || cols > s->max_cols)) {
+            char why[64];
+            snprintf(why, sizeof(why), "mapa %dx%d je nad limit servera %dx%d",
+                     rows, cols, s->max_rows, s->max_cols);
+            reject_start(s, why);
+        }
+        else if (parsed >= 5) {
+            s->map_rows = rows;
+            s->map_cols = cols;
+            s->world = (strncmp(world_str, "WALLS", 5) == 0) ? WORLD_WALLS : WORLD_WRAP;
+            s->has_obstacles = (strncmp(obs_str, "OBS", 3) == 0) ? 1 : 0;
+
+            if (strncmp(mode_str, "STANDARD", 8) == 0) {
+                s->game_mode = MODE_STANDARD;
+                s->time_limit = 0;
+            } else {
+                s->game_mode = MODE_TIMED;
+                s->time_limit = (parsed >= 6) ? time_limit : 60;
+            }
+
+            if (strstr(buf, " " START_ARENA) != NULL) {
+                if (s->arena_remote) {
+                    defer_to_arena(s, buf);
+                    return;
+                }
+                if (s->arena) {
+                    parse_format(s, buf);
+                    join_arena(s);
+                    return;
+                }
+            }
+            parse_format(s, buf);
+
+            /*
+             * Hru inicializujeme hned, aby prikazy za START v tom istom
+             * segmente (napr. MOVE) isli uz do bezicej hry.
+             * Game loop ju zacne tickovat az po state = RUNNING.
+             */
+            start_game(s);
+        }
+    }
+    /* WATCH - divak areny, ramce mu posiela vlastnik areny (manager) */
+    else if (strncmp(buf, CMD_WATCH, strlen(CMD_WATCH)) == 0) {
+        if (s->state != STATE_WAITING || s->handoff[0]) return;
+        if (s->arena_remote) {
+            defer_to_arena(s, buf);
+            return;
+        }
+        if (!s->arena) return;
+
+        parse_format(s, buf);
+        s->frames.player = VIEWER_SPECTATOR;
+        s->watching = 1;
+        s->state = STATE_RUNNING;
+        if (s->client_fd >= 0) printf("Spectator joined\n");
+    }
+    /* MOVE, PAUSE, RESUME - stav sa kontroluje az v ticku (session_apply_input) */
+    else if (strncmp(buf, CMD_MOVE " ", strlen(CMD_MOVE) + 1) == 0) {
+        /* MOVE <smer> [seq] */
+        const char* arg = buf + strlen(CMD_MOVE) + 1;
+        unsigned seq = 0;
+        if (arg[0] && arg[1] == ' ') sscanf(arg + 2, "%u", &seq);
+        queue_input(s, IN_MOVE, arg[0], seq);
+    }
+    else if (strncmp(buf, CMD_PAUSE, strlen(CMD_PAUSE)) == 0) {
+        queue_input(s, IN_PAUSE, 0, 0);
+    }
+    else if (strncmp(buf, CMD_RESUME, strlen(CMD_RESUME)) == 0) {
+        queue_input(s, IN_RESUME, 0, 0);
+    }
+    /* QUIT */
+    else if (strncmp(buf, CMD_QUIT, strlen(CMD_QUIT)) == 0) {
+        if (s->watching) s->state = STATE_GAMEOVER;
+        else queue_input(s, IN_QUIT, 0, 0);
+    }
+}
+
+/* Prikaz do zaznamu hry v ticku, v ktorom sa aplikuje */
+static void record_input(Session* s, const InputCmd* c) {
+    char cmd = 0;
+    switch (c->type) {
+    case IN_MOVE:   if (c->dir && strchr("wasd", c->dir)) cmd = c->dir; break;
+    case IN_PAUSE:  cmd = GAMELOG_PAUSE; break;
+    case IN_RESUME: cmd = GAMELOG_RESUME; break;
+    case IN_QUIT:   cmd = GAMELOG_QUIT; break;
+    }
+    if (cmd) gamelog_cmd(s->log, (unsigned)s->ticks, cmd);
+}
+
+void session_apply_input(Session* s) {
+    InputCmd c;
+    long long now = ticker_now_ns();
+    int popped = 0;
+
+    while (input_pop(&s->input, &c)) {
+        popped++;
+        long long wait = now - c.t_ns;
+        s->applied++;
+        s->input_wait_sum_ns += wait;
+        if (wait > s->input_wait_max_ns) s->input_wait_max_ns = wait;
+
+        if (s->log) record_input(s, &c);
+
+        switch (c.type) {
+        case IN_MOVE:
+            /* len v stave RUNNING */
+            if (s->state == STATE_RUNNING) game_set_dir(s->g, s->player, c.dir);
+            if (c.seq) {
+                s->ack_seq = c.seq;
+                s->ack_tick = (unsigned)s->ticks;
+                s->ack_wait_ns = wait;
+                s->ack_pending = 1;
+            }
+            break;
+        case IN_PAUSE:
+            /* arenu nepozastavi jeden hrac */
+            if (s->state == STATE_RUNNING && !s->shared && !s->g->paused) {
+                game_pause(s->g);
+                s->state = STATE_PAUSED;
+            }
+            break;
+        case IN_RESUME:
+            if (s->state == STATE_PAUSED && s->g->paused) {
+                game_resume(s->g);
+                s->state = STATE_RUNNING;
+            }
+            break;
+        case IN_QUIT:
+            /* z areny hraca odoberie vlastnik session (game_leave) */
+            if (s->shared) s->state = STATE_GAMEOVER;
+            else s->g->running = 0;
+            break;
+        }
+    }
+
+    /* vo fronte je miesto: zobudi recv thread, ak caka s odlozenymi prikazmi */
+    if (popped > 0 && s->room_fd >= 0) {
+        uint64_t one = 1;
+        if (write(s->room_fd, &one, sizeof(one)) < 0) perror("write room_fd");
+    }
+}
+
+int session_feed(Session* s, const char* data, int len) {
+    int done = 0;
+
+    for (int i = 0; i < len; i++) {
+        char c = data[i];
+
+        if (c == '\n') {
+            if (!s->in_overflow && s->in_len > 0) {
+                if (s->in[s->in_len - 1] == '\r') s->in_len--;
+                s->in[s->in_len] = '\0';
+                session_handle_command(s, s->in);
+                done++;
+            }
+            s->in_len = 0;
+            s->in_overflow = 0;
+        }
+        else if (s->in_len < CMD_LINE_MAX - 1) {
+            s->in[s->in_len++] = c;
+        }
+        else {
+            s->in_overflow = 1;
+        }
+    }
+
+    return done;
+}
+
+/* Miesto pre novy ramec na konci s->out (odoslane bajty sa posunu na zaciatok) */
+static char* out_space(Session* s, int* cap) {
+    OutQueue* q = &s->out;
+    if (q->off > 0) {
+        memmove(q->buf, q->buf + q->off, (size_t)(q->len - q->off));
+        q->len -= q->off;
+        q->off = 0;
+    }
+    *cap = OUT_QUEUE_CAP - q->len;
+    return q->buf + q->len;
+}
+
+/*
+ * Pod g->mtx: stav hry pre ramec (vyrez + cisla do hlavicky). Bezny ramec
+ * len ked klient prevzal predchadzajuci, inak sa zmeny zlucia (vrati 0).
+ */
+static int capture_frame(Session* s, const GameState* g) {
+    if (session_pending(s)) return 0;
+    frame_capture(&s->frames, g);
+    return 1;
+}
+
+/* Mimo zamku: ACK a ramec zo stavu zachyteneho v capture_frame */
+static int push_frame(Session* s, int captured) {
+    if (!captured) {
+        s->out.coalesced++;
+        return 0;
+    }
+    int cap;
+    char* p = out_space(s, &cap);
+
+    /* ACK ide tesne pred ramec, v ktorom je MOVE prvykrat vidiet */
+    int a = 0;
+    if (s->ack_pending) {
+        a = frame_build_ack(&s->frames, s->ack_seq, s->ack_tick,
+                            (unsigned)(s->ack_wait_ns / 1000), p, cap);
+        s->ack_pending = 0;
+        p += a;
+        cap -= a;
+    }
+
+    /* 0 = ramec sa nezmestil, pocita sa len ACK */
+    int n = frame_encode(&s->frames, p, cap < FRAME_CAP ? cap : FRAME_CAP);
+    s->out.len += a + n;
+    if (n > 0) s->out.frames++;
+    return a + n;
+}
+
+/* GAME_OVER sa prida vzdy, aj za este neodoslany ramec (kratky, sklada sa pod g->mtx) */
+static int push_game_over(Session* s, GameState* g, int timeout) {
+    int cap;
+    char* p = out_space(s, &cap);
+    int n = frame_build_game_over(&s->frames, g, timeout, p, cap);
+    if (n > cap) n = cap;
+    s->out.len += n;
+    if (n > 0) s->out.frames++;
+    return n;
+}
+
+/*
+ * Tick hraca v arene: len kontrola odpojenia/smrti a ramec.
+ * Prikazy uz aplikoval manager pred game_step, arena sa tu nemeni.
+ */
+static int shared_tick(Session* s) {
+    GameState* g = s->g;
+
+    if (s->client_disconnected) {
+        if (s->disconnected_at == 0) s->disconnected_at = time(NULL);
+        if ((int)(time(NULL) - s->disconnected_at) >= DISCONNECT_TIMEOUT_SEC) {
+            s->state = STATE_GAMEOVER;
+        }
+    }
+
+    /* pod zamkom areny len kopia vyrezu, ramec sa sklada az po odomknuti */
+    int over, n = 0, captured = 0;
+    pthread_mutex_lock(&g->mtx);
+    over = s->state == STATE_GAMEOVER || !g->players[s->player].snake.alive;
+    if (over) {
+        s->state = STATE_GAMEOVER;
+        n = push_game_over(s, g, 0);
+    }
+    else {
+        captured = capture_frame(s, g);
+    }
+    pthread_mutex_unlock(&g->mtx);
+
+    return over ? n : push_frame(s, captured);
+}
+
+/* Tick vlastnej hry (klasicka hra, bot) */
+static int local_tick(Session* s) {
+    GameState* g = s->g;
+
+    /* nesposobi okamzite ukoncenie, ale korektne dobehne */
+    int stopped = 0;
+    if (s->client_disconnected) {
+        if (s->disconnected_at == 0) s->disconnected_at = time(NULL);
+        if ((int)(time(NULL) - s->disconnected_at) >= DISCONNECT_TIMEOUT_SEC) {
+            pthread_mutex_lock(&g->mtx);
+            stopped = g->running;
+            g->running = 0;
+            pthread_mutex_unlock(&g->mtx);
+        }
+    }
+    else {
+        s->disconnected_at = 0;
+    }
+
+    /*
+     * Pod zamkom zmena stavu hry a kopia toho, co ramec potrebuje
+     * (frame_capture: vyrez a cisla do hlavicky). Ramec sa z kopie sklada
+     * az po odomknuti, hru uz necita.
+     */
+    int timeout = 0, over, n = 0, captured = 0;
+    pthread_mutex_lock(&g->mtx);
+
+    session_apply_input(s);
+
+    /* Kontrola casoveho limitu */
+    if (g->game_mode == MODE_TIMED && g->time_limit_sec > 0 && s->state == STATE_RUNNING) {
+        if (game_elapsed_ms(g) >= (long long)g->time_limit_sec * 1000) {
+            g->running = 0;
+            timeout = 1;
+        }
+    }
+
+    /* game_step len v RUNNING */
+    if (!timeout && s->state == STATE_RUNNING && !g->paused) {
+        game_step(g);
+    }
+
+    /* GAME OVER */
+    over = !g->running;
+    if (over) {
+        end_record(s, stopped || timeout);
+        s->state = STATE_GAMEOVER;
+        n = push_game_over(s, g, timeout);
+    }
+    else {
+        captured = capture_frame(s, g);
+    }
+
+    pthread_mutex_unlock(&g->mtx);
+
+    /* SCORE, MODE, TIME + mapa (cela alebo len zmeny) */
+    return over ? n : push_frame(s, captured);
+}
+
+int session_tick(Session* s) {
+    int n = s->shared ? shared_tick(s) : local_tick(s);
+    s->ticks++;
+    return n;
+}
+
+int session_flush(Session* s) {
+    OutQueue* q = &s->out;
+
+    if (s->client_fd < 0 || s->client_disconnected) {
+        q->len = q->off = 0;
+        return 1;
+    }
+
+    while (q->off < q->len) {
+        ssize_t r = send(s->client_fd, q->buf + q->off, (size_t)(q->len - q->off),
+                         MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (r < 0) {
+            if (errno == EINTR) continue;
+            return errno == EAGAIN || errno == EWOULDBLOCK ? 0 : -1;
+        }
+        q->off += (int)r;
+    }
+    q->len = q->off = 0;
+    return 1;
+}
@@ -0,0 +1,175 @@
+#pragma once
+#include <time.h>
+#include <stdatomic.h>
+
+#include "game.h"
+#include "frame.h"
+#include "input_queue.h"
+#include "gamelog.h"
+
+/* Stavovy protokol */
+typedef enum {
+    STATE_WAITING,
+    STATE_RUNNING,
+    STATE_PAUSED,
+    STATE_GAMEOVER
+} ServerState;
+
+// Maximalna dlzka jedneho prikazu (riadku) od klienta
+#define CMD_LINE_MAX 256
+
+// Najvacsia mapa, ktoru START dostane, ak server nema -M
+#define MAP_LIMIT_DEFAULT 1000
+
+// Najviac bajtov v jednom volani session_feed (recv buffer servera)
+#define FEED_MAX 1024
+
+// Prikazov z jedneho session_feed: najkratsi ("QUIT\n") ma 5 B, + rozpracovany riadok
+#define INPUT_PARK_CAP ((FEED_MAX + CMD_LINE_MAX) / 5 + 1)
+
+// Najvacsi ramec (FULL 30x60 ma ~1.9 KB) a fronta na odoslanie
+#define FRAME_CAP 8192
+#define OUT_QUEUE_CAP (2 * FRAME_CAP)
+
+/*
+ * Odchadzajuce bajty pre klienta, posielaju sa neblokujuco (session_flush).
+ * Kym klient neprevezme cely ramec, novy sa nesklada - zmeny z tychto tickov
+ * pojdu naraz v dalsom ramci (DELTA/BINARY: jedna spojena delta, FULL:
+ * najnovsia mapa). Pomaly klient tak nezdrzi loop a fronta nerastie.
+ */
+typedef struct {
+    char buf[OUT_QUEUE_CAP];
+    int len;                // bajty v buf
+    int off;                // z toho uz odoslane
+    long frames;            // zlozene ramce
+    long coalesced;         // ticky bez ramca (klient nestihal), zlucene do dalsieho
+} OutQueue;
+
+/*
+ * Session = jedno pripojenie klienta a jeho hra.
+ * Pouziva ju klasicky server (recv thread + game loop)
+ * aj epoll manager (vela hier v jednom procese).
+ *
+ * Po START hru meni len vlakno, ktore ju tickuje: prikazy z recv threadu
+ * (MOVE, PAUSE, RESUME, QUIT) idu cez InputQueue a aplikuju sa na zaciatku
+ * ticku. state a client_disconnected su atomicke (citaju ich obe vlakna).
+ */
+typedef struct {
+    int client_fd;
+    GameState* g;
+    int player;             // index hraca v g (v klasickej hre 0)
+    int shared;             // hra je arena, krokuje ju manager (nie session_tick),
+                            // hraca z nej odobera az vlastnik session (game_leave)
+    GameState* arena;       // arena, ku ktorej sa da pridat (START ... ARENA), alebo NULL
+    int arena_remote;       // arena je inde (iny event loop): START ... ARENA / WATCH
+                            // sa neodohra tu, ale odlozi do handoff
+    char handoff[CMD_LINE_MAX]; // odlozeny START/WATCH pre vlastnika areny ("" = ziadny)
+    int watching;           // divak areny (WATCH): bez hry, ramce posiela manager
+    _Atomic ServerState state;
+    WorldType world;
+    GameMode game_mode;
+    int time_limit;
+    int map_rows;
+    int map_cols;
+    int max_rows;           // limit mapy zo START (server -M), vacsia sa odmietne
+    int max_cols;
+    int has_obstacles;
+    int game_started;
+    atomic_int client_disconnected;
+    time_t disconnected_at;
+    FrameState frames;      // format ramcov a co klient naposledy videl
+
+    /* prijate bajty, ktore este netvoria cely riadok (TCP moze riadok rozdelit) */
+    char in[CMD_LINE_MAX];
+    int in_len;
+    int in_overflow;        // prilis dlhy riadok, zahadzujeme do '\n'
+    unsigned long commands; // pocet spracovanych prikazov
+
+    /* prikazy pre game loop a ako dlho cakali vo fronte */
+    InputQueue input;
+    /* prikazy, pre ktore nebolo vo fronte miesto: zapisovatel ich drzi a necita
+       socket, kym game loop frontu neuvolni (session_push_parked) */
+    InputCmd parked[INPUT_PARK_CAP];
+    int parked_len;
+    int room_fd;            // eventfd: tick prevzal prikazy (recv thread caka), -1 = nie
+    unsigned long applied;
+    long long input_wait_sum_ns;
+    long long input_wait_max_ns;
+
+    /* posledny aplikovany MOVE so seq, potvrdi sa klientovi pred dalsim ramcom (ACK) */
+    unsigned long ticks;    // ticky session (cislo ticku v ACK)
+    unsigned ack_seq;
+    unsigned ack_tick;
+    long long ack_wait_ns;
+    int ack_pending;
+
+    /* zaznam hry pre replay (len vlastna hra, nie arena) */
+    const char* record_dir; // kam zapisovat zaznamy, NULL = nezaznamenava sa
+    int tick_ms;            // perioda ticku do hlavicky zaznamu
+    GameLogWriter* log;     // otvoreny zaznam bezicej hry
+    char record_path[256];  // subor posledneho zaznamu
+
+    OutQueue out;
+} Session;
+
+void session_init(Session* s, int client_fd, GameState* g);
+
+/*
+  Spracuje jeden prikaz od klienta (START, WATCH, MOVE, PAUSE, RESUME, QUIT).
+  START hned inicializuje hru a prepne session do RUNNING. Mapu nad
+  max_rows x max_cols (alebo bez pamate na hru) odmietne: klient dostane
+  ERROR a session je GAMEOVER.
+  MOVE, PAUSE, RESUME a QUIT sa len zaradia do s->input (session_apply_input).
+  START s tokenom ARENA (a nastavenym s->arena) prida hraca do areny;
+  ak arena este nebezi, vytvori ju s parametrami z tohto START.
+  WATCH (len s nastavenym s->arena) urobi zo session divaka areny.
+  S arena_remote sa START ... ARENA a WATCH len odlozia do s->handoff:
+  vlastnik session ju presunie k arene a prikaz zopakuje s nastavenym s->arena.
+*/
+void session_handle_command(Session* s, const char* buf);
+
+/*
+  Prida prijate bajty (najviac FEED_MAX) do bufferu a spracuje vsetky kompletne
+  prikazy (riadky ukoncene '\n'), bez zamykania hry.
+  Nekompletny zvysok pocka na dalsi recv. Vrati pocet spracovanych prikazov.
+  Ked je s->input plna, prikazy zostanu v s->parked - volajuci potom necita
+  socket, kym session_push_parked nevrati 0.
+*/
+int session_feed(Session* s, const char* data, int len);
+
+/*
+  Zapisovatel: presunie odlozene prikazy do s->input, kolko sa zmesti.
+  Vrati pocet prikazov, ktore este cakaju.
+*/
+int session_push_parked(Session* s);
+
+/*
+  Aplikuje prikazy zo s->input na hru (volajuci drzi s->g->mtx).
+  Ak nejake prevzal a s->room_fd je nastaveny, zapise don (zobudi recv thread).
+  session_tick to robi sam; arenu krokuje manager, ten ho vola
+  pre vsetkych hracov pred game_step.
+*/
+void session_apply_input(Session* s);
+
+/*
+  Jeden tick hry: prikazy zo s->input, kontrola odpojenia a casu, game_step
+  a kopia vyrezu pre ramec (pod g->mtx), potom zlozenie ramca do s->out
+  uz mimo zamku.
+  V arene (shared) game_step nerobi - arenu krokuje jej vlastnik raz za tick.
+  Ak v s->out este caka predchadzajuci ramec, novy sa nesklada (coalesced).
+  Ak hra skoncila, nastavi state na STATE_GAMEOVER a GAME_OVER prida vzdy.
+  Vrati pocet bajtov pridanych do s->out.
+*/
+int session_tick(Session* s);
+
+/*
+  Posle cakajuce bajty z s->out bez blokovania (MSG_DONTWAIT).
+  Bez klienta (bot, odpojeny) frontu len zahodi.
+  Vrati 1 (fronta prazdna), 0 (socket plny, zvysok neskor), -1 (chyba spojenia).
+*/
+int session_flush(Session* s);
+
+// Ci v s->out este nieco caka na odoslanie
+static inline int session_pending(const Session* s) {
+    return s->out.len > s->out.off;
+}
@@ -0,0 +1,84 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/timerfd.h>
+
+#include "ticker.h"
+
+long long ticker_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static struct timespec to_timespec(long long ns) {
+    struct timespec ts;
+    ts.tv_sec = (time_t)(ns / 1000000000LL);
+    ts.tv_nsec = (long)(ns % 1000000000LL);
+    return ts;
+}
+
+void ticker_init(Ticker* t, int tick_ms) {
+    if (tick_ms < 1) tick_ms = 1;
+    t->period_ns = (long long)tick_ms * 1000000LL;
+    t->next_ns = ticker_now_ns() + t->period_ns;
+    t->ticks = 0;
+    t->overruns = 0;
+    t->jitter_sum_ns = 0;
+    t->jitter_max_ns = 0;
+}
+
+void ticker_wait(Ticker* t) {
+    struct timespec ts = to_timespec(t->next_ns);
+
+    /* pri signale spime dalej do toho isteho absolutneho terminu */
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {}
+
+    ticker_fired(t);
+}
+
+void ticker_fired(Ticker* t) {
+    long long late = ticker_now_ns() - t->next_ns;
+    if (late < 0) late = 0;
+
+    t->ticks++;
+    t->jitter_sum_ns += late;
+    if (late > t->jitter_max_ns) t->jitter_max_ns = late;
+
+    /* terminy, ktore uz presli, preskocime - kadencia ostava zarovnana */
+    long missed = (long)(late / t->period_ns);
+    t->overruns += missed;
+    t->next_ns += (long long)(missed + 1) * t->period_ns;
+}
+
+int ticker_timerfd(const Ticker* t) {
+    int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (fd < 0) { perror("timerfd_create"); return -1; }
+
+    struct itimerspec its;
+    its.it_value = to_timespec(t->next_ns);
+    its.it_interval = to_timespec(t->period_ns);
+    if (timerfd_settime(fd, TFD_TIMER_ABSTIME, &its, NULL) < 0) {
+        perror("timerfd_settime");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+void ticker_report(Ticker* t, const char* label) {
+    if (t->ticks == 0) return;
+
+    printf("%s ticks=%ld period=%.1f ms jitter avg=%.3f ms max=%.3f ms overruns=%ld\n",
+           label, t->ticks, t->period_ns / 1e6,
+           (double)t->jitter_sum_ns / t->ticks / 1e6, t->jitter_max_ns / 1e6,
+           t->overruns);
+
+    t->ticks = 0;
+    t->overruns = 0;
+    t->jitter_sum_ns = 0;
+    t->jitter_max_ns = 0;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+/*
+ * Pevna kadencia tickov podla CLOCK_MONOTONIC.
+ * Terminy su absolutne (start + k * perioda), takze cas prace v ticku
+ * ani oneskorene prebudenie sa nescitavaju do driftu.
+ *
+ * Pouzitie:
+ *  - klasicky server: ticker_wait() (clock_nanosleep s TIMER_ABSTIME)
+ *  - epoll loop: ticker_timerfd() do epoll, po precitani ticker_fired()
+ */
+typedef struct {
+    long long period_ns;
+    long long next_ns;      // absolutny termin najblizsieho ticku
+
+    /* statistika (ticker_report ju vynuluje) */
+    long ticks;
+    long overruns;          // vynechane terminy (tick trval dlhsie ako perioda)
+    long long jitter_sum_ns;
+    long long jitter_max_ns;
+} Ticker;
+
+long long ticker_now_ns(void);
+
+// Prvy tick o jednu periodu od teraz
+void ticker_init(Ticker* t, int tick_ms);
+
+// Uspi vlakno do najblizsieho terminu, potom ticker_fired()
+void ticker_wait(Ticker* t);
+
+/*
+  Zaznamena tick: oneskorenie oproti terminu (jitter) a vynechane terminy.
+  Posunie termin na dalsi buduci (zmeskane sa nedobiehaju).
+*/
+void ticker_fired(Ticker* t);
+
+/*
+  timerfd (neblokujuci) s rovnakymi terminmi ako ticker.
+  Po kazdom EPOLLIN treba precitat 8 bajtov a zavolat ticker_fired().
+  Vrati fd alebo -1.
+*/
+int ticker_timerfd(const Ticker* t);
+
+// Vypise "ticks=.. jitter avg/max .. overruns=.." s prefixom a vynuluje statistiku
+void ticker_report(Ticker* t, const char* label);